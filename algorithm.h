@@ -0,0 +1,292 @@
+#ifndef UNITS_ALGORITHM_H
+#define UNITS_ALGORITHM_H
+
+#include "number.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+namespace units {
+
+// How the terms of a reduction are added up. neumaier keeps a running
+// compensation term and loses almost nothing to rounding, pairwise adds
+// blocks of terms in a balanced tree and naive is a plain loop. Reductions
+// over numbers that are not floating point always use a plain loop.
+enum class summation {
+    naive,
+    neumaier,
+    pairwise
+};
+
+namespace algorithm_detail {
+
+    // Sum with the Neumaier compensation term kept separately.
+    template<typename T>
+    struct compensated {
+        T sum{};
+        T compensation{};
+
+        constexpr void add(const T& x) noexcept {
+            const T t = sum + x;
+            if ((sum < T{} ? -sum : sum) >= (x < T{} ? -x : x)) {
+                compensation += (sum - t) + x;
+            } else {
+                compensation += (x - t) + sum;
+            }
+            sum = t;
+        }
+
+        constexpr void merge(const compensated& x) noexcept {
+            add(x.sum);
+            compensation += x.compensation;
+        }
+
+        constexpr T result() const noexcept {
+            return sum + compensation;
+        }
+    };
+
+    // Below this many terms pairwise summation adds in a plain loop.
+    constexpr std::size_t pairwise_block = 128;
+
+    // Terms summed by one task of a parallel reduction.
+    constexpr std::size_t parallel_chunk = std::size_t{1} << 14;
+
+    template<typename T, typename Term>
+    T naive_sum(const Term& term, std::size_t first, std::size_t last) {
+        T sum{};
+        for (std::size_t i = first; i < last; ++i) {
+            sum += term(i);
+        }
+        return sum;
+    }
+
+    template<typename T, typename Term>
+    T pairwise_sum(const Term& term, std::size_t first, std::size_t last) {
+        if (last - first <= pairwise_block) {
+            return naive_sum<T>(term, first, last);
+        }
+        const std::size_t middle = first + (last - first) / 2;
+        return pairwise_sum<T>(term, first, middle) + pairwise_sum<T>(term, middle, last);
+    }
+
+    // Sums term(i) for i in [first, last). The compensation term of a
+    // neumaier sum is kept so that partial sums can be merged.
+    template<typename T, typename Term>
+    compensated<T> sum(const Term& term, std::size_t first, std::size_t last, summation mode) {
+        compensated<T> result;
+        if constexpr (number_traits<T>::is_floating_point) {
+            if (mode == summation::neumaier) {
+                for (std::size_t i = first; i < last; ++i) {
+                    result.add(term(i));
+                }
+                return result;
+            }
+            if (mode == summation::pairwise) {
+                result.sum = pairwise_sum<T>(term, first, last);
+                return result;
+            }
+        }
+        result.sum = naive_sum<T>(term, first, last);
+        return result;
+    }
+
+#ifdef __cpp_lib_execution
+    // Splits [0, size) into chunks, sums every chunk as one task of policy and
+    // merges the partial sums with compensation.
+    template<typename T, typename Policy, typename Term>
+    compensated<T> parallel_sum(Policy&& policy, const Term& term, std::size_t size, summation mode) {
+        std::vector<std::size_t> chunks((size + parallel_chunk - 1) / parallel_chunk);
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            chunks[i] = i * parallel_chunk;
+        }
+        return std::transform_reduce(std::forward<Policy>(policy),
+            chunks.begin(), chunks.end(), compensated<T>{},
+            [](compensated<T> a, const compensated<T>& b) {
+                a.merge(b);
+                return a;
+            },
+            [&](std::size_t first) {
+                const std::size_t last = first + parallel_chunk < size ? first + parallel_chunk : size;
+                return sum<T>(term, first, last, mode);
+            });
+    }
+
+    template<typename P>
+    using enable_if_policy = std::enable_if_t<
+        std::is_execution_policy<std::decay_t<P>>::value, int>;
+#endif
+
+    // Random access to the elements of a range of unit_number.
+    template<typename Range>
+    auto first_of(const Range& range) {
+        using std::begin;
+        auto first = begin(range);
+        static_assert(std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<decltype(first)>::iterator_category>::value,
+            "Reductions need a random access range.");
+        return first;
+    }
+
+    template<typename Range>
+    std::size_t size_of(const Range& range) {
+        using std::begin;
+        using std::end;
+        return static_cast<std::size_t>(std::distance(begin(range), end(range)));
+    }
+
+    template<typename Range>
+    using element_of = std::decay_t<decltype(*std::begin(std::declval<const Range&>()))>;
+
+    template<typename Range>
+    using quantity_of = unit_number<typename element_of<Range>::number_type,
+                                    typename element_of<Range>::unit_type>;
+
+    template<typename Range, typename Transform>
+    using unary_result = std::decay_t<decltype(std::declval<const Transform&>()(
+        std::declval<quantity_of<Range>>()))>;
+
+    template<typename A, typename B, typename Transform>
+    using binary_result = std::decay_t<decltype(std::declval<const Transform&>()(
+        std::declval<quantity_of<A>>(), std::declval<quantity_of<B>>()))>;
+
+    struct identity {
+        template<typename Q>
+        constexpr Q operator() (const Q& x) const noexcept { return x; }
+    };
+
+    struct multiplies {
+        template<typename A, typename B>
+        constexpr auto operator() (const A& a, const B& b) const noexcept { return a * b; }
+    };
+
+    // term(i) is the raw value of transform applied to the elements at i.
+    template<typename Result, typename Iterator, typename Transform>
+    auto unary_term(Iterator first, const Transform& transform) {
+        return [first, &transform](std::size_t i) {
+            return Result{transform(first[i])}.value();
+        };
+    }
+
+    template<typename Result, typename IteratorA, typename IteratorB, typename Transform>
+    auto binary_term(IteratorA a, IteratorB b, const Transform& transform) {
+        return [a, b, &transform](std::size_t i) {
+            return Result{transform(a[i], b[i])}.value();
+        };
+    }
+
+} /* namespace algorithm_detail */
+
+// Sum of transform(x) over the elements x of range. transform returns a
+// unit_number, which is also the type of the result.
+template<typename Range, typename Transform,
+         typename Result = algorithm_detail::unary_result<Range, Transform>>
+Result transform_reduce(const Range& range, Transform transform,
+                        summation mode = summation::neumaier) {
+    using result_t = Result;
+    const auto term = algorithm_detail::unary_term<result_t>(
+        algorithm_detail::first_of(range), transform);
+    return result_t{algorithm_detail::sum<typename result_t::number_type>(
+        term, 0, algorithm_detail::size_of(range), mode).result()};
+}
+
+// Sum of transform(a[i], b[i]). Both ranges must have the same size.
+template<typename A, typename B, typename Transform,
+         typename Result = algorithm_detail::binary_result<A, B, Transform>>
+Result transform_reduce(const A& a, const B& b, Transform transform,
+                        summation mode = summation::neumaier) {
+    using result_t = Result;
+    assert(algorithm_detail::size_of(a) == algorithm_detail::size_of(b));
+    const auto term = algorithm_detail::binary_term<result_t>(
+        algorithm_detail::first_of(a), algorithm_detail::first_of(b), transform);
+    return result_t{algorithm_detail::sum<typename result_t::number_type>(
+        term, 0, algorithm_detail::size_of(a), mode).result()};
+}
+
+template<typename Range>
+auto reduce(const Range& range, summation mode = summation::neumaier) {
+    return ::units::transform_reduce(range, algorithm_detail::identity{}, mode);
+}
+
+// Sum of a[i] * b[i], in the unit of the product: the dot of a force and a
+// dist range is an energy.
+template<typename A, typename B>
+auto dot(const A& a, const B& b, summation mode = summation::neumaier) {
+    return ::units::transform_reduce(a, b, algorithm_detail::multiplies{}, mode);
+}
+
+// Arithmetic mean, in the unit of the elements. The range must not be empty.
+template<typename Range>
+auto mean(const Range& range, summation mode = summation::neumaier) {
+    const auto sum = ::units::reduce(range, mode);
+    assert(algorithm_detail::size_of(range) != 0);
+    using result_t = std::decay_t<decltype(sum)>;
+    using number_t = typename result_t::number_type;
+    return result_t{sum.value() / static_cast<number_t>(algorithm_detail::size_of(range))};
+}
+
+#ifdef __cpp_lib_execution
+
+// The same reductions run as chunks under an execution policy. The partial
+// sums of the chunks are always merged with compensation.
+
+template<typename Policy, typename Range, typename Transform,
+         algorithm_detail::enable_if_policy<Policy> = 0,
+         typename Result = algorithm_detail::unary_result<Range, Transform>>
+Result transform_reduce(Policy&& policy, const Range& range, Transform transform,
+                        summation mode = summation::neumaier) {
+    using result_t = Result;
+    const auto term = algorithm_detail::unary_term<result_t>(
+        algorithm_detail::first_of(range), transform);
+    return result_t{algorithm_detail::parallel_sum<typename result_t::number_type>(
+        std::forward<Policy>(policy), term, algorithm_detail::size_of(range), mode).result()};
+}
+
+template<typename Policy, typename A, typename B, typename Transform,
+         algorithm_detail::enable_if_policy<Policy> = 0,
+         typename Result = algorithm_detail::binary_result<A, B, Transform>>
+Result transform_reduce(Policy&& policy, const A& a, const B& b, Transform transform,
+                        summation mode = summation::neumaier) {
+    using result_t = Result;
+    assert(algorithm_detail::size_of(a) == algorithm_detail::size_of(b));
+    const auto term = algorithm_detail::binary_term<result_t>(
+        algorithm_detail::first_of(a), algorithm_detail::first_of(b), transform);
+    return result_t{algorithm_detail::parallel_sum<typename result_t::number_type>(
+        std::forward<Policy>(policy), term, algorithm_detail::size_of(a), mode).result()};
+}
+
+template<typename Policy, typename Range, algorithm_detail::enable_if_policy<Policy> = 0>
+auto reduce(Policy&& policy, const Range& range, summation mode = summation::neumaier) {
+    return ::units::transform_reduce(std::forward<Policy>(policy), range,
+                                     algorithm_detail::identity{}, mode);
+}
+
+template<typename Policy, typename A, typename B, algorithm_detail::enable_if_policy<Policy> = 0>
+auto dot(Policy&& policy, const A& a, const B& b, summation mode = summation::neumaier) {
+    return ::units::transform_reduce(std::forward<Policy>(policy), a, b,
+                                     algorithm_detail::multiplies{}, mode);
+}
+
+template<typename Policy, typename Range, algorithm_detail::enable_if_policy<Policy> = 0>
+auto mean(Policy&& policy, const Range& range, summation mode = summation::neumaier) {
+    const auto sum = ::units::reduce(std::forward<Policy>(policy), range, mode);
+    assert(algorithm_detail::size_of(range) != 0);
+    using result_t = std::decay_t<decltype(sum)>;
+    using number_t = typename result_t::number_type;
+    return result_t{sum.value() / static_cast<number_t>(algorithm_detail::size_of(range))};
+}
+
+#endif
+
+} /* namespace units */
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef UNITS_ATOMIC_H
+#define UNITS_ATOMIC_H
+
+#include "number.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace units {
+
+// A unit_number that threads can update without a lock, such as a total of
+// energy or elapsed time accumulated by workers. The number is a
+// std::atomic<N>, so operations cost exactly what they cost on the raw
+// atomic. fetch_add and fetch_sub are native for integral numbers and a
+// compare and swap loop for floating point numbers, which std::atomic only
+// gains in C++20.
+//
+// Operands have the type unit_number<N, U>, so quantities of other units
+// convert like in assignments: lossless changes of scale are accepted and
+// other dimensions are rejected at compile time.
+template<typename N, typename U>
+class atomic_quantity {
+    static_assert(std::is_integral<N>::value or std::is_floating_point<N>::value,
+        "Atomic quantities need integral or floating point numbers.");
+
+public:
+    using value_type = unit_number<N, U>;
+    using number_type = N;
+    using unit_type = U;
+
+    static constexpr bool is_always_lock_free = std::atomic<N>::is_always_lock_free;
+
+    atomic_quantity() noexcept = default;
+
+    constexpr atomic_quantity(const value_type& x) noexcept : value_(x.value()) {}
+
+    atomic_quantity(const atomic_quantity&) = delete;
+    atomic_quantity& operator= (const atomic_quantity&) = delete;
+    atomic_quantity& operator= (const atomic_quantity&) volatile = delete;
+
+    // Every operation has a volatile overload, like std::atomic, so that a
+    // volatile std::atomic of a quantity works too.
+
+    bool is_lock_free() const noexcept { return value_.is_lock_free(); }
+    bool is_lock_free() const volatile noexcept { return value_.is_lock_free(); }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return value_type{value_.load(order)};
+    }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const volatile noexcept {
+        return value_type{value_.load(order)};
+    }
+
+    void store(const value_type& x, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        value_.store(x.value(), order);
+    }
+
+    void store(const value_type& x, std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        value_.store(x.value(), order);
+    }
+
+    value_type exchange(const value_type& x, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return value_type{value_.exchange(x.value(), order)};
+    }
+
+    value_type exchange(const value_type& x,
+                        std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        return value_type{value_.exchange(x.value(), order)};
+    }
+
+    // On failure expected receives the current value.
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compare_exchange<false>(value_, expected, desired, order);
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        return compare_exchange<false>(value_, expected, desired, order);
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order success, std::memory_order failure) noexcept {
+        return compare_exchange<false>(value_, expected, desired, success, failure);
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order success, std::memory_order failure) volatile noexcept {
+        return compare_exchange<false>(value_, expected, desired, success, failure);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compare_exchange<true>(value_, expected, desired, order);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        return compare_exchange<true>(value_, expected, desired, order);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order success, std::memory_order failure) noexcept {
+        return compare_exchange<true>(value_, expected, desired, success, failure);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order success, std::memory_order failure) volatile noexcept {
+        return compare_exchange<true>(value_, expected, desired, success, failure);
+    }
+
+    // Add or subtract x and return the previous value.
+
+    value_type fetch_add(const value_type& x, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return value_type{add(value_, x.value(), order)};
+    }
+
+    value_type fetch_add(const value_type& x,
+                         std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        return value_type{add(value_, x.value(), order)};
+    }
+
+    value_type fetch_sub(const value_type& x, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return value_type{subtract(value_, x.value(), order)};
+    }
+
+    value_type fetch_sub(const value_type& x,
+                         std::memory_order order = std::memory_order_seq_cst) volatile noexcept {
+        return value_type{subtract(value_, x.value(), order)};
+    }
+
+    operator value_type() const noexcept { return load(); }
+    operator value_type() const volatile noexcept { return load(); }
+
+    value_type operator= (const value_type& x) noexcept {
+        store(x);
+        return x;
+    }
+
+    value_type operator= (const value_type& x) volatile noexcept {
+        store(x);
+        return x;
+    }
+
+    // Add or subtract x and return the new value.
+    value_type operator+= (const value_type& x) noexcept { return fetch_add(x) + x; }
+    value_type operator+= (const value_type& x) volatile noexcept { return fetch_add(x) + x; }
+    value_type operator-= (const value_type& x) noexcept { return fetch_sub(x) - x; }
+    value_type operator-= (const value_type& x) volatile noexcept { return fetch_sub(x) - x; }
+
+private:
+    // The helpers take the atomic as A, std::atomic<N> or its volatile
+    // form, so that both overloads of each operation share them.
+
+    // The orders are passed on as given, so that std::atomic derives the
+    // failure order of the single order forms.
+    template<bool Strong, typename A, typename... Orders>
+    static bool compare_exchange(A& value, value_type& expected, const value_type& desired,
+                                 Orders... orders) noexcept {
+        N x = expected.value();
+        const bool done = Strong ? value.compare_exchange_strong(x, desired.value(), orders...)
+                                 : value.compare_exchange_weak(x, desired.value(), orders...);
+        expected = value_type{x};
+        return done;
+    }
+
+    template<typename A>
+    static N add(A& value, N x, std::memory_order order) noexcept {
+        if constexpr (std::is_integral<N>::value) {
+            return value.fetch_add(x, order);
+        } else {
+            return update(value, x, order);
+        }
+    }
+
+    template<typename A>
+    static N subtract(A& value, N x, std::memory_order order) noexcept {
+        if constexpr (std::is_integral<N>::value) {
+            return value.fetch_sub(x, order);
+        } else {
+            return update(value, -x, order);
+        }
+    }
+
+    // Adds x with a compare and swap loop and returns the previous number.
+    template<typename A>
+    static N update(A& value, N x, std::memory_order order) noexcept {
+        N old = value.load(std::memory_order_relaxed);
+        while (not value.compare_exchange_weak(old, old + x, order, std::memory_order_relaxed)) {
+        }
+        return old;
+    }
+
+    std::atomic<N> value_;
+};
+
+static_assert(sizeof(atomic_quantity<double, Scalar>) == sizeof(std::atomic<double>),
+    "atomic_quantity must have the size of the raw atomic.");
+
+} /* namespace units */
+
+// std::atomic of a quantity is its atomic_quantity, so generic code using
+// std::atomic<T> gets the checked arithmetic too.
+template<typename N, typename U>
+struct std::atomic<units::unit_number<N, U>> : public units::atomic_quantity<N, U> {
+    using units::atomic_quantity<N, U>::atomic_quantity;
+    using units::atomic_quantity<N, U>::operator=;
+};
+
+#endif
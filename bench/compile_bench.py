@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""Compile-time scalability benchmark for the units headers.
+
+Generates synthetic translation units that stress the metaprogramming in
+meta.h, unit.h and compile_string.h, compiles each of them with the
+configured compiler and records wall time, peak compiler RSS and (when the
+compiler supports -ftime-trace) the time spent per metafunction.
+
+The result is written as JSON. With --baseline the run is compared against
+an earlier report and the script exits non-zero on a regression.
+"""
+
+import argparse, json, os, random, re, shlex, statistics, subprocess, sys, tempfile, time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+CATALOG_UNITS = [
+    "metric::meter", "metric::kilogram", "second", "metric::ampere",
+    "metric::kelvin", "metric::mole", "metric::candela", "metric::radian",
+    "metric::newton", "metric::joule", "metric::watt", "metric::volt",
+    "metric::ohm", "metric::farad", "metric::tesla", "metric::pascal",
+    "metric::hertz", "metric::coloumb", "metric::weber", "metric::henry",
+]
+
+
+def int_list(text):
+    return [int(x) for x in text.split(",") if x]
+
+
+def gen_dimensions(n):
+    """N synthetic dimensions, multiplied into one unit and divided back out."""
+    lines = ['#include "number.h"', "", "namespace bench {", "using namespace units;", ""]
+    for i in range(n):
+        lines.append("DEFINE_DIMENSION(dim%d, base%d);" % (i, i))
+    lines.append("")
+    lines.append("void run() {")
+    lines.append("    auto product = " + " * ".join("base%d" % i for i in range(n)) + ";")
+    lines.append("    auto quotient = product" + "".join(" / base%d" % i for i in range(n)) + ";")
+    lines.append("    (void)quotient;")
+    lines.append("}")
+    lines.append("")
+    lines.append("} /* namespace bench */")
+    return "\n".join(lines) + "\n"
+
+
+def gen_expressions(m, length, seed):
+    """M chained products and quotients of catalog quantities."""
+    rng = random.Random(seed)
+    lines = ['#include "metric.h"', "", "namespace bench {", "using namespace units;", ""]
+    lines.append("double run(double x) {")
+    lines.append("    double sum = 0;")
+    for i in range(m):
+        expr = "(x * %s)" % rng.choice(CATALOG_UNITS)
+        for _ in range(length - 1):
+            expr += " %s (x * %s)" % (rng.choice("*/"), rng.choice(CATALOG_UNITS))
+        lines.append("    sum += (%s).value();" % expr)
+    lines.append("    return sum;")
+    lines.append("}")
+    lines.append("")
+    lines.append("} /* namespace bench */")
+    return "\n".join(lines) + "\n"
+
+
+def gen_aliases(k, seed):
+    """K SETUP_UNIT_TYPES aliases of derived units."""
+    rng = random.Random(seed)
+    lines = ['#include "metric.h"', "", "namespace bench {", "using namespace units;", ""]
+    for i in range(k):
+        a, b = rng.choice(CATALOG_UNITS), rng.choice(CATALOG_UNITS)
+        power = rng.randint(-3, 3) or 1
+        lines.append("SETUP_UNIT_TYPES(alias%d, %s * %s.exp<%d>());" % (i, a, b, power))
+    lines.append("")
+    lines.append("} /* namespace bench */")
+    return "\n".join(lines) + "\n"
+
+
+def gen_catalog():
+    """The whole catalog, as included by a typical client."""
+    return '#include "metric.h"\n#include "us.h"\n#include "imperial.h"\n'
+
+
+def make_cases(args):
+    cases = [("catalog", {}, gen_catalog())]
+    for n in args.dims:
+        cases.append(("dimensions", {"n": n}, gen_dimensions(n)))
+    for m in args.exprs:
+        cases.append(("expressions", {"m": m, "length": args.expr_length},
+                      gen_expressions(m, args.expr_length, args.seed)))
+    for k in args.aliases:
+        cases.append(("aliases", {"k": k}, gen_aliases(k, args.seed)))
+    return cases
+
+
+def supports_flag(cxx, flag):
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "probe.cpp")
+        with open(src, "w") as f:
+            f.write("int main() {}\n")
+        cmd = cxx + [flag, "-c", src, "-o", os.path.join(tmp, "probe.o")]
+        return subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode == 0
+
+
+def compiler_version(cxx):
+    out = subprocess.run(cxx + ["--version"], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                         universal_newlines=True).stdout
+    return out.splitlines()[0] if out else "unknown"
+
+
+def compile_once(cmd):
+    """Runs the compiler, returns (wall seconds, peak RSS in KiB)."""
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    stderr = proc.stderr.read()
+    proc.stderr.close()
+    _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.perf_counter() - start
+    proc.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    if proc.returncode != 0:
+        raise RuntimeError("compilation failed: %s\n%s" % (" ".join(map(shlex.quote, cmd)),
+                                                           stderr.decode(errors="replace")))
+    return wall, usage.ru_maxrss
+
+
+TEMPLATE_NAME = re.compile(r"^([\w:]+)")
+
+
+def summarize_trace(path, top):
+    """Aggregates template instantiation time per metafunction."""
+    with open(path) as f:
+        trace = json.load(f)
+    totals = {}
+    for event in trace.get("traceEvents", []):
+        if event.get("name") not in ("InstantiateClass", "InstantiateFunction"):
+            continue
+        detail = event.get("args", {}).get("detail", "")
+        match = TEMPLATE_NAME.match(detail)
+        name = match.group(1) if match else detail
+        entry = totals.setdefault(name, {"name": name, "count": 0, "us": 0})
+        entry["count"] += 1
+        entry["us"] += event.get("dur", 0)
+    phases = {}
+    for event in trace.get("traceEvents", []):
+        name = event.get("name", "")
+        if name.startswith("Total "):
+            phases[name[len("Total "):]] = event.get("dur", 0)
+    ranked = sorted(totals.values(), key=lambda e: e["us"], reverse=True)
+    return {"phases_us": phases, "instantiations": ranked[:top]}
+
+
+def run_case(args, cxx, flags, time_trace, workdir, case):
+    kind, params, source = case
+    tag = kind + "".join("_%s%s" % (k, v) for k, v in sorted(params.items()))
+    src = os.path.join(workdir, tag + ".cpp")
+    obj = os.path.join(workdir, tag + ".o")
+    with open(src, "w") as f:
+        f.write(source)
+    cmd = cxx + flags + ["-I", ROOT, "-c", src, "-o", obj]
+    walls, rss = [], []
+    for _ in range(args.repeat):
+        wall, peak = compile_once(cmd)
+        walls.append(wall)
+        rss.append(peak)
+    result = {
+        "name": tag, "kind": kind, "params": params,
+        "lines": source.count("\n"),
+        "wall_s": {"min": min(walls), "median": statistics.median(walls)},
+        "peak_rss_kib": max(rss),
+    }
+    if time_trace:
+        compile_once(cmd + ["-ftime-trace"])
+        trace = os.path.splitext(obj)[0] + ".json"
+        if os.path.exists(trace):
+            result["time_trace"] = summarize_trace(trace, args.top)
+    print("%-28s %8.3f s %10d KiB" % (tag, result["wall_s"]["median"], result["peak_rss_kib"]),
+          file=sys.stderr)
+    return result
+
+
+def compare(report, baseline, max_regression):
+    """Returns a list of messages for cases slower or bigger than allowed."""
+    previous = {case["name"]: case for case in baseline.get("cases", [])}
+    failures = []
+    for case in report["cases"]:
+        old = previous.get(case["name"])
+        if old is None:
+            continue
+        for metric, new_value, old_value in (
+                ("wall", case["wall_s"]["min"], old["wall_s"]["min"]),
+                ("rss", case["peak_rss_kib"], old["peak_rss_kib"])):
+            if old_value > 0 and new_value > old_value * (1 + max_regression):
+                failures.append("%s: %s regressed from %s to %s" % (case["name"], metric, old_value, new_value))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--cxxflags", default="-std=c++17 -O0",
+                        help="flags passed to every compilation")
+    parser.add_argument("--dims", type=int_list, default=[4, 8, 16, 32],
+                        help="comma separated numbers of synthetic dimensions")
+    parser.add_argument("--exprs", type=int_list, default=[50, 200],
+                        help="comma separated numbers of chained expressions")
+    parser.add_argument("--expr-length", type=int, default=6,
+                        help="factors per chained expression")
+    parser.add_argument("--aliases", type=int_list, default=[50, 200],
+                        help="comma separated numbers of SETUP_UNIT_TYPES aliases")
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--top", type=int, default=20,
+                        help="metafunctions listed per case in the time trace summary")
+    parser.add_argument("--no-time-trace", action="store_true")
+    parser.add_argument("--out", default="-", help="report file, - for stdout")
+    parser.add_argument("--baseline", help="earlier report to compare against")
+    parser.add_argument("--max-regression", type=float, default=0.15,
+                        help="allowed relative increase of wall time and RSS")
+    args = parser.parse_args()
+
+    cxx = shlex.split(args.cxx)
+    flags = shlex.split(args.cxxflags)
+    time_trace = not args.no_time_trace and supports_flag(cxx, "-ftime-trace")
+
+    with tempfile.TemporaryDirectory() as workdir:
+        cases = [run_case(args, cxx, flags, time_trace, workdir, case) for case in make_cases(args)]
+
+    report = {
+        "compiler": compiler_version(cxx),
+        "cxx": args.cxx,
+        "cxxflags": args.cxxflags,
+        "time_trace": time_trace,
+        "cases": cases,
+    }
+    text = json.dumps(report, indent=2) + "\n"
+    if args.out == "-":
+        sys.stdout.write(text)
+    else:
+        directory = os.path.dirname(args.out)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        with open(args.out, "w") as f:
+            f.write(text)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            failures = compare(report, json.load(f), args.max_regression)
+        for failure in failures:
+            print(failure, file=sys.stderr)
+        if failures:
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
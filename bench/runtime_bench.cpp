@@ -0,0 +1,299 @@
+// Runtime abstraction penalty benchmark for unit_number.
+//
+// Runs the same kernels once on unit_number and once on the raw numbers the
+// units wrap, and reports the best time per element of each and their
+// ratio. The kernels follow main.cpp (get_area, get_speed, get_frequency)
+// and add conversions through unit_multiple, a reduction and arithmetic on
+// mixed float and double numbers.
+//
+// The exit status is non-zero when some ratio exceeds --threshold, so the
+// run can gate a build. make bench-runtime builds and runs it once per
+// optimization level.
+
+#include "metric.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace units;
+using namespace units::metric;
+
+#define BENCH_NOINLINE __attribute__((noinline))
+
+namespace bench {
+
+using km_t = decltype(1.0 * kilometer);
+using float_dist = unit_number<float, dist_u>;
+
+constexpr area<double> get_area(dist<double> width, dist<double> height) {
+    return width * height;
+}
+
+constexpr velocity<double> get_speed(acceleration<double> accel, units::time<double> elapsed) {
+    return accel * elapsed;
+}
+
+constexpr frequency<double> get_frequency(units::time<double> x) {
+    return scalar_double{1.0} / x;
+}
+
+// Inputs of both variants hold the same numbers.
+struct inputs {
+    std::vector<dist<double>> width, height;
+    std::vector<acceleration<double>> accel;
+    std::vector<units::time<double>> elapsed;
+    std::vector<km_t> kilometers;
+    std::vector<float_dist> short_dist;
+
+    std::vector<double> raw_width, raw_height, raw_accel, raw_elapsed, raw_kilometers;
+    std::vector<float> raw_short_dist;
+};
+
+struct outputs {
+    std::vector<area<double>> areas;
+    std::vector<velocity<double>> speeds;
+    std::vector<frequency<double>> frequencies;
+    std::vector<dist<double>> meters;
+    std::vector<velocity<double>> mixed;
+
+    std::vector<double> raw;
+};
+
+// Each kernel returns a number that depends on all of its work, which the
+// driver folds into a volatile sink.
+
+BENCH_NOINLINE double area_units(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.areas[i] = get_area(in.width[i], in.height[i]);
+    }
+    return out.areas[n - 1].value();
+}
+
+BENCH_NOINLINE double area_raw(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.raw[i] = in.raw_width[i] * in.raw_height[i];
+    }
+    return out.raw[n - 1];
+}
+
+BENCH_NOINLINE double speed_units(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.speeds[i] = get_speed(in.accel[i], in.elapsed[i]);
+    }
+    return out.speeds[n - 1].value();
+}
+
+BENCH_NOINLINE double speed_raw(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.raw[i] = in.raw_accel[i] * in.raw_elapsed[i];
+    }
+    return out.raw[n - 1];
+}
+
+BENCH_NOINLINE double frequency_units(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.frequencies[i] = get_frequency(in.elapsed[i]);
+    }
+    return out.frequencies[n - 1].value();
+}
+
+BENCH_NOINLINE double frequency_raw(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.raw[i] = 1.0 / in.raw_elapsed[i];
+    }
+    return out.raw[n - 1];
+}
+
+BENCH_NOINLINE double convert_units(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.meters[i] = in.kilometers[i];
+    }
+    return out.meters[n - 1].value();
+}
+
+BENCH_NOINLINE double convert_raw(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.raw[i] = in.raw_kilometers[i] * 1000.0;
+    }
+    return out.raw[n - 1];
+}
+
+BENCH_NOINLINE double reduce_units(const inputs& in, outputs&, std::size_t n) {
+    area<double> sum{0.0};
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += in.width[i] * in.height[i];
+    }
+    return sum.value();
+}
+
+BENCH_NOINLINE double reduce_raw(const inputs& in, outputs&, std::size_t n) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += in.raw_width[i] * in.raw_height[i];
+    }
+    return sum;
+}
+
+BENCH_NOINLINE double mixed_units(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.mixed[i] = in.short_dist[i] / in.elapsed[i];
+    }
+    return out.mixed[n - 1].value();
+}
+
+BENCH_NOINLINE double mixed_raw(const inputs& in, outputs& out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out.raw[i] = in.raw_short_dist[i] / in.raw_elapsed[i];
+    }
+    return out.raw[n - 1];
+}
+
+using kernel_fn = double (*)(const inputs&, outputs&, std::size_t);
+
+struct kernel {
+    const char* name;
+    kernel_fn units;
+    kernel_fn raw;
+};
+
+constexpr kernel kernels[] = {
+    {"get_area", area_units, area_raw},
+    {"get_speed", speed_units, speed_raw},
+    {"get_frequency", frequency_units, frequency_raw},
+    {"km_to_m", convert_units, convert_raw},
+    {"sum_area", reduce_units, reduce_raw},
+    {"mixed_float", mixed_units, mixed_raw},
+};
+
+struct options {
+    const char* label = "";
+    double threshold = 1.10;
+    std::size_t size = 4096;
+    int repeat = 200;
+    int trials = 25;
+};
+
+volatile double sink;
+
+// Best time of trials runs of repeat calls, in nanoseconds per element.
+double time_kernel(kernel_fn f, const inputs& in, outputs& out, const options& opt) {
+    using clock = std::chrono::steady_clock;
+    double best = 0.0;
+    for (int t = 0; t < opt.trials; ++t) {
+        double acc = 0.0;
+        const auto start = clock::now();
+        for (int r = 0; r < opt.repeat; ++r) {
+            acc += f(in, out, opt.size);
+        }
+        const auto stop = clock::now();
+        sink = acc;
+        const double ns = std::chrono::duration<double, std::nano>(stop - start).count() /
+                          (static_cast<double>(opt.repeat) * static_cast<double>(opt.size));
+        if (t == 0 or ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+inputs make_inputs(std::size_t n) {
+    inputs in;
+    unsigned state = 12345;
+    const auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return 1.0 + static_cast<double>((state >> 8) & 0xffff) / 4096.0;
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        const double w = next(), h = next(), a = next(), t = next(), k = next();
+        const float s = static_cast<float>(next());
+        in.width.push_back(w * meter);
+        in.height.push_back(h * meter);
+        in.accel.push_back(a * mps2);
+        in.elapsed.push_back(t * second);
+        in.kilometers.push_back(k * kilometer);
+        in.short_dist.push_back(s * meter);
+        in.raw_width.push_back(w);
+        in.raw_height.push_back(h);
+        in.raw_accel.push_back(a);
+        in.raw_elapsed.push_back(t);
+        in.raw_kilometers.push_back(k);
+        in.raw_short_dist.push_back(s);
+    }
+    return in;
+}
+
+outputs make_outputs(std::size_t n) {
+    outputs out;
+    out.areas.assign(n, area<double>{0.0});
+    out.speeds.assign(n, velocity<double>{0.0});
+    out.frequencies.assign(n, frequency<double>{0.0});
+    out.meters.assign(n, dist<double>{0.0});
+    out.mixed.assign(n, velocity<double>{0.0});
+    out.raw.assign(n, 0.0);
+    return out;
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s [--label text] [--threshold ratio] [--size n] [--repeat n] [--trials n]\n",
+        program);
+}
+
+bool parse_options(int argc, char** argv, options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 == argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--label") == 0) {
+            opt.label = value;
+        } else if (std::strcmp(argv[i - 1], "--threshold") == 0) {
+            opt.threshold = std::atof(value);
+        } else if (std::strcmp(argv[i - 1], "--size") == 0) {
+            opt.size = static_cast<std::size_t>(std::atol(value));
+        } else if (std::strcmp(argv[i - 1], "--repeat") == 0) {
+            opt.repeat = std::atoi(value);
+        } else if (std::strcmp(argv[i - 1], "--trials") == 0) {
+            opt.trials = std::atoi(value);
+        } else {
+            return false;
+        }
+    }
+    return opt.threshold > 0.0 and opt.size > 0 and opt.repeat > 0 and opt.trials > 0;
+}
+
+} /* namespace bench */
+
+int main(int argc, char** argv) {
+    bench::options opt;
+    if (not bench::parse_options(argc, argv, opt)) {
+        bench::usage(argv[0]);
+        return 2;
+    }
+    const bench::inputs in = bench::make_inputs(opt.size);
+    bench::outputs out = bench::make_outputs(opt.size);
+
+    std::printf("%-6s %-14s %12s %12s %8s\n", "build", "kernel", "units ns/op", "raw ns/op", "ratio");
+    int failures = 0;
+    for (const bench::kernel& k : bench::kernels) {
+        // The first trial of each variant warms the caches, and only the
+        // best trial counts.
+        const double raw = bench::time_kernel(k.raw, in, out, opt);
+        const double with_units = bench::time_kernel(k.units, in, out, opt);
+        const double ratio = with_units / raw;
+        const bool failed = ratio > opt.threshold;
+        failures += failed;
+        std::printf("%-6s %-14s %12.3f %12.3f %8.3f%s\n", opt.label, k.name, with_units, raw, ratio,
+                    failed ? "  FAIL" : "");
+    }
+    if (failures != 0) {
+        std::printf("%d kernel(s) above the ratio threshold %.2f\n", failures, opt.threshold);
+        return 1;
+    }
+    return 0;
+}
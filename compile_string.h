@@ -3,8 +3,9 @@
 
 #include "meta.h"
 
+#include <cstdint>
 #include <type_traits>
-#include <iostream>
+#include <ostream>
 #include <string>
 
 namespace units {
@@ -16,6 +17,20 @@ namespace units {
         return temp{};                                                         \
     }())
 
+namespace string_detail {
+
+    // 64-bit FNV-1a hash of size characters.
+    constexpr std::uint64_t fnv1a(const char* chars, std::size_t size) {
+        std::uint64_t result = 14695981039346656037ull;
+        for (std::size_t i = 0; i < size; ++i) {
+            result ^= static_cast<unsigned char>(chars[i]);
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+
+} /* namespace string_detail */
+
 template<char c>
 using char_type = std::integral_constant<char, c>;
 
@@ -43,6 +58,11 @@ public:
         return std::string{c_str()};
     }
 
+    // 64-bit FNV-1a hash of the characters, usable as a compact identity.
+    static constexpr std::uint64_t hash() {
+        return string_detail::fnv1a(c_string, sizeof...(Chars));
+    }
+
     template<typename... RChars>
     constexpr bool operator< (compile_string<RChars...> other) const {
         return compare_with(other) < 0;
@@ -75,7 +95,7 @@ public:
 
 private:
 
-    static const char c_string[];
+    static constexpr char c_string[] = {Chars::value..., '\0'};
 
     template<typename... RChars>
     constexpr int compare_with(compile_string<RChars...>) const {
@@ -84,9 +104,6 @@ private:
     }
 };
 
-template<typename... Chars>
-const char compile_string<Chars...>::c_string[] {Chars::value..., '\0'};
-
 template<typename Left, typename Right>
 struct compile_string_less {
     static constexpr bool value = (Left{} < Right{});
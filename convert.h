@@ -0,0 +1,117 @@
+#ifndef UNITS_CONVERT_H
+#define UNITS_CONVERT_H
+
+#include "number.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace units {
+
+namespace convert_detail {
+
+    // Factor taking numbers in multiples of From to multiples of To.
+    template<typename From, typename To>
+    struct factor {
+        static_assert(number_detail::same_base<From, To>::value,
+            "Can only convert between scales of the same unit.");
+        using ratio = std::ratio_divide<number_detail::scale_of<From>, number_detail::scale_of<To>>;
+    };
+
+    template<typename From, typename To>
+    using factor_of = typename factor<number_detail::normalize<From>,
+                                      number_detail::normalize<To>>::ratio;
+
+    template<typename V>
+    using target_unit = number_detail::normalize<std::remove_cv_t<V>>;
+
+    // out[i] = in[i] * R. out may alias in. Floating point numbers of one
+    // type use the vector multiply kernel, everything else goes through
+    // the exact scalar conversion.
+    template<typename R, typename N, typename M>
+    void rescale(const N* in, M* out, std::size_t n) noexcept {
+        using conversion = number_detail::conversion<R, M, N>;
+        if constexpr (conversion::is_identity and std::is_same<N, M>::value) {
+            if (in != out) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[i] = in[i];
+                }
+            }
+        } else if constexpr (conversion::is_floating and std::is_same<N, M>::value) {
+            const M x = number_detail::number_constant<M>(conversion::factor);
+            vector_detail::binary_right<vector_detail::multiply_op>(in, x, out, n);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = conversion::apply(in[i]);
+            }
+        }
+    }
+
+    template<typename R, typename N, typename M>
+    void rescale(const N* in, std::ptrdiff_t in_stride,
+                 M* out, std::ptrdiff_t out_stride, std::size_t n) noexcept {
+        using conversion = number_detail::conversion<R, M, N>;
+        for (std::size_t i = 0; i < n; ++i) {
+            *out = conversion::apply(*in);
+            in += in_stride;
+            out += out_stride;
+        }
+    }
+
+} /* namespace convert_detail */
+
+// Converts n raw numbers in multiples of from into multiples of to. from and
+// to are units or unit_multiples of the same unit, such as us::mile and
+// metric::meter, and the factor between them is resolved at compile time.
+template<typename N, typename M, typename From, typename To>
+void convert(const N* in, M* out, std::size_t n, const From&, const To&) noexcept {
+    convert_detail::rescale<convert_detail::factor_of<From, To>>(in, out, n);
+}
+
+// In place variant of the above.
+template<typename N, typename From, typename To>
+void convert(N* values, std::size_t n, const From& from, const To& to) noexcept {
+    convert(values, values, n, from, to);
+}
+
+// Strided variant of the above. Strides are counted in numbers, not bytes, and
+// may be negative.
+template<typename N, typename M, typename From, typename To>
+void convert(const N* in, std::ptrdiff_t in_stride, M* out, std::ptrdiff_t out_stride,
+             std::size_t n, const From&, const To&) noexcept {
+    convert_detail::rescale<convert_detail::factor_of<From, To>>(in, in_stride, out, out_stride, n);
+}
+
+// Converts between spans that carry their units. Both spans must have the
+// same size.
+template<typename N, typename U, typename M, typename V>
+void convert(const unit_span<N, U>& in, const unit_span<M, V>& out) noexcept {
+    static_assert(not std::is_const<M>::value, "Cannot convert into a span of constants.");
+    assert(in.size() == out.size());
+    convert(in.data(), out.data(), in.size(), U{}, V{});
+}
+
+template<typename N, typename U, typename M, typename V>
+void convert(const unit_vector<N, U>& in, unit_vector<M, V>& out) noexcept {
+    convert(in.span(), out.span());
+}
+
+// Returns a copy of the numbers of in converted to the scale V, which may be
+// given as decltype of a catalog entry such as decltype(us::mile).
+template<typename V, typename N, typename U>
+unit_vector<std::remove_cv_t<N>, convert_detail::target_unit<V>> convert(const unit_span<N, U>& in) {
+    unit_vector<std::remove_cv_t<N>, convert_detail::target_unit<V>> out(in.size());
+    convert(in, out.span());
+    return out;
+}
+
+template<typename V, typename N, typename U>
+unit_vector<N, convert_detail::target_unit<V>> convert(const unit_vector<N, U>& in) {
+    return convert<V>(in.span());
+}
+
+} /* namespace units */
+
+#endif
@@ -14,6 +14,10 @@ struct dimension {
         "Dimension base unit must be a compile-time string.");
     using name = Name;
     using base_unit = BaseUnit;
+
+    // Ordering and equality of dimensions only look at this key, the names
+    // are kept for printing.
+    static constexpr std::uint64_t id = Name::hash();
 };
 
 template<typename N, typename B>
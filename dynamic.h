@@ -0,0 +1,242 @@
+#ifndef UNITS_DYNAMIC_H
+#define UNITS_DYNAMIC_H
+
+#include "general.h"
+#include "meta.h"
+#include "metric.h"
+#include "number.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ratio>
+#include <type_traits>
+
+namespace units {
+
+namespace dynamic_detail {
+
+    // Base dimensions a unit known only at run time can have. Each gets one
+    // signed byte of a packed 64-bit exponent word, in this order from the
+    // least significant byte.
+    using dimensions = meta::type_list<
+        time_dim,
+        metric::dist_dim,
+        metric::mass_dim,
+        metric::temperature_dim,
+        metric::current_dim,
+        metric::luminous_intensity_dim,
+        metric::substance_dim,
+        metric::angle_dim
+    >;
+
+    constexpr std::size_t dimension_count = dimensions::size();
+    static_assert(dimension_count == 8, "Exponents must fill exactly one 64-bit word.");
+
+    // The sign bit of every byte.
+    constexpr std::uint64_t high_bits = 0x8080808080808080ull;
+
+    // Bytewise two's complement a + b and a - b, without carries between
+    // the bytes.
+    constexpr std::uint64_t add(std::uint64_t a, std::uint64_t b) noexcept {
+        return ((a & ~high_bits) + (b & ~high_bits)) ^ ((a ^ b) & high_bits);
+    }
+
+    constexpr std::uint64_t subtract(std::uint64_t a, std::uint64_t b) noexcept {
+        return ((a | high_bits) - (b & ~high_bits)) ^ ((a ^ ~b) & high_bits);
+    }
+
+    // Whether some byte of the sum or difference r of a and b overflowed.
+    constexpr bool add_overflows(std::uint64_t a, std::uint64_t b, std::uint64_t r) noexcept {
+        return (~(a ^ b) & (a ^ r) & high_bits) != 0;
+    }
+
+    constexpr bool subtract_overflows(std::uint64_t a, std::uint64_t b, std::uint64_t r) noexcept {
+        return ((a ^ b) & (a ^ r) & high_bits) != 0;
+    }
+
+    template<typename DimExp>
+    constexpr std::uint64_t pack() noexcept {
+        constexpr std::size_t i = meta::index_of<typename DimExp::dimension, dimensions>::value;
+        static_assert(i < dimension_count, "Only units of the catalog dimensions are dynamic.");
+        static_assert(DimExp::exponent >= -128 and DimExp::exponent <= 127,
+            "Dynamic exponents must fit in a byte.");
+        return static_cast<std::uint64_t>(static_cast<std::uint8_t>(DimExp::exponent)) << (8 * i);
+    }
+
+    template<typename U> struct packed_impl;
+
+    template<typename... DimExps>
+    struct packed_impl<unit<DimExps...>> {
+        static constexpr std::uint64_t value = (std::uint64_t{0} | ... | pack<DimExps>());
+    };
+
+    // Packed exponents of the base unit of U.
+    template<typename U>
+    constexpr std::uint64_t packed_of = packed_impl<number_detail::base_unit_of<U>>::value;
+
+    // Whether a unit_number<M, U> converts to N in the base unit of U
+    // without loss.
+    template<typename N, typename M, typename U>
+    using is_lossless = number_detail::is_lossless_conversion<N, number_detail::base_unit_of<U>, M, U>;
+
+} /* namespace dynamic_detail */
+
+// A number with dimensions known only at run time. The number is kept in the
+// base unit of its dimensions, and the exponents of the catalog dimensions
+// in dynamic_detail::dimensions are packed into one word, so multiplying
+// adds two words and checking dimensions compares two words.
+//
+// Adding, subtracting or comparing quantities of different dimensions and
+// exponents leaving [-128, 127] are errors caught by assertions.
+template<typename N = double>
+class dynamic_quantity {
+    static_assert(number_traits<N>::is_number,
+        "N-parameter must be arithmetic or have number_traits.");
+
+public:
+    using number_type = N;
+
+    // The scalar x.
+    constexpr explicit dynamic_quantity(const N& x = N{}) noexcept : value_(x), exponents_(0) {}
+
+    // x in the base unit of the dimensions with the packed exponents.
+    constexpr dynamic_quantity(const N& x, std::uint64_t exponents) noexcept
+        : value_(x), exponents_(exponents) {}
+
+    // Implicit when the change to the base unit is lossless, as for the
+    // conversions of unit_number, and explicit when it may truncate, such as
+    // millimeters into an integral dynamic_quantity.
+    template<typename M, typename U, std::enable_if_t<
+        dynamic_detail::is_lossless<N, M, U>::value, int> = 0>
+    constexpr dynamic_quantity(const unit_number<M, U>& x) noexcept
+        : value_(number_detail::rescale<number_detail::scale_of<U>, N>(x.value())),
+          exponents_(dynamic_detail::packed_of<U>) {}
+
+    template<typename M, typename U, std::enable_if_t<
+        not dynamic_detail::is_lossless<N, M, U>::value, int> = 0>
+    constexpr explicit dynamic_quantity(const unit_number<M, U>& x) noexcept
+        : value_(number_detail::rescale<number_detail::scale_of<U>, N>(x.value())),
+          exponents_(dynamic_detail::packed_of<U>) {}
+
+    // The number in the base unit, such as meter/second for a speed.
+    constexpr const N& value() const noexcept { return value_; }
+
+    constexpr std::uint64_t exponents() const noexcept { return exponents_; }
+
+    // Exponent of the catalog dimension at index i, or of Dim.
+    constexpr int exponent(std::size_t i) const noexcept {
+        assert(i < dynamic_detail::dimension_count);
+        return static_cast<std::int8_t>(static_cast<std::uint8_t>(exponents_ >> (8 * i)));
+    }
+
+    template<typename Dim>
+    constexpr int exponent() const noexcept {
+        constexpr std::size_t i = meta::index_of<Dim, dynamic_detail::dimensions>::value;
+        static_assert(i < dynamic_detail::dimension_count, "Dim is not a dynamic dimension.");
+        return exponent(i);
+    }
+
+    // Whether x has the dimensions of U.
+    template<typename U>
+    constexpr bool is() const noexcept {
+        return exponents_ == dynamic_detail::packed_of<U>;
+    }
+
+    constexpr bool same_dimensions(const dynamic_quantity& x) const noexcept {
+        return exponents_ == x.exponents_;
+    }
+
+    constexpr dynamic_quantity operator+ () const noexcept { return *this; }
+    constexpr dynamic_quantity operator- () const noexcept { return {-value_, exponents_}; }
+
+    constexpr dynamic_quantity& operator+= (const dynamic_quantity& x) noexcept {
+        assert(same_dimensions(x));
+        value_ += x.value_;
+        return *this;
+    }
+
+    constexpr dynamic_quantity& operator-= (const dynamic_quantity& x) noexcept {
+        assert(same_dimensions(x));
+        value_ -= x.value_;
+        return *this;
+    }
+
+    constexpr dynamic_quantity& operator*= (const dynamic_quantity& x) noexcept {
+        const std::uint64_t e = dynamic_detail::add(exponents_, x.exponents_);
+        assert(not dynamic_detail::add_overflows(exponents_, x.exponents_, e));
+        value_ *= x.value_;
+        exponents_ = e;
+        return *this;
+    }
+
+    constexpr dynamic_quantity& operator/= (const dynamic_quantity& x) noexcept {
+        const std::uint64_t e = dynamic_detail::subtract(exponents_, x.exponents_);
+        assert(not dynamic_detail::subtract_overflows(exponents_, x.exponents_, e));
+        value_ /= x.value_;
+        exponents_ = e;
+        return *this;
+    }
+
+    constexpr dynamic_quantity& operator*= (const N& x) noexcept {
+        value_ *= x;
+        return *this;
+    }
+
+    constexpr dynamic_quantity& operator/= (const N& x) noexcept {
+        value_ /= x;
+        return *this;
+    }
+
+    // Hidden friends, so that a unit_number on either side converts.
+    friend constexpr dynamic_quantity operator+ (dynamic_quantity a, const dynamic_quantity& b) noexcept { return a += b; }
+    friend constexpr dynamic_quantity operator- (dynamic_quantity a, const dynamic_quantity& b) noexcept { return a -= b; }
+    friend constexpr dynamic_quantity operator* (dynamic_quantity a, const dynamic_quantity& b) noexcept { return a *= b; }
+    friend constexpr dynamic_quantity operator/ (dynamic_quantity a, const dynamic_quantity& b) noexcept { return a /= b; }
+    friend constexpr dynamic_quantity operator* (dynamic_quantity a, const N& b) noexcept { return a *= b; }
+    friend constexpr dynamic_quantity operator* (const N& a, dynamic_quantity b) noexcept { return b *= a; }
+    friend constexpr dynamic_quantity operator/ (dynamic_quantity a, const N& b) noexcept { return a /= b; }
+
+    friend constexpr bool operator== (const dynamic_quantity& a, const dynamic_quantity& b) noexcept {
+        return a.exponents_ == b.exponents_ and a.value_ == b.value_;
+    }
+
+    friend constexpr bool operator!= (const dynamic_quantity& a, const dynamic_quantity& b) noexcept {
+        return not (a == b);
+    }
+
+    friend constexpr bool operator< (const dynamic_quantity& a, const dynamic_quantity& b) noexcept {
+        assert(a.same_dimensions(b));
+        return a.value_ < b.value_;
+    }
+
+    friend constexpr bool operator> (const dynamic_quantity& a, const dynamic_quantity& b) noexcept { return b < a; }
+    friend constexpr bool operator<= (const dynamic_quantity& a, const dynamic_quantity& b) noexcept { return not (b < a); }
+    friend constexpr bool operator>= (const dynamic_quantity& a, const dynamic_quantity& b) noexcept { return not (a < b); }
+
+private:
+    N value_;
+    std::uint64_t exponents_;
+};
+
+template<typename N, typename U>
+dynamic_quantity(const unit_number<N, U>&) -> dynamic_quantity<N>;
+
+// The static quantity Q, such as metric::velocity<double> or a unit_number in
+// kilometers, if x has its dimensions, and nothing otherwise. The check is
+// one compare and the change of scale one multiplication by a constant.
+template<typename Q, typename N>
+constexpr std::optional<Q> checked_cast(const dynamic_quantity<N>& x) noexcept {
+    static_assert(number_detail::is_unit_number<Q>::value, "Q must be a unit_number.");
+    using unit_t = typename Q::unit_type;
+    if (not x.template is<unit_t>()) {
+        return std::nullopt;
+    }
+    using ratio = std::ratio_divide<std::ratio<1>, number_detail::scale_of<unit_t>>;
+    return Q{number_detail::rescale<ratio, typename Q::number_type>(x.value())};
+}
+
+} /* namespace units */
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef UNITS_EXPRESSION_H
+#define UNITS_EXPRESSION_H
+
+#include "number.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace units {
+
+namespace expression_detail {
+
+    // Leaf reading the numbers of a unit_vector or unit_span.
+    template<typename N, typename U>
+    struct range_leaf {
+        using number_type = N;
+        using unit_type = U;
+        static constexpr bool sized = true;
+        static constexpr bool batchable = vector_detail::batch<N>::width != 0;
+
+        const N* data;
+        std::size_t count;
+
+        std::size_t size() const noexcept { return count; }
+        N element(std::size_t i) const noexcept { return data[i]; }
+
+        template<typename Vec>
+        auto load(std::size_t i) const noexcept { return Vec::load(data + i); }
+    };
+
+    // Leaf repeating one number for every element.
+    template<typename N, typename U>
+    struct scalar_leaf {
+        using number_type = N;
+        using unit_type = U;
+        static constexpr bool sized = false;
+        static constexpr bool batchable = vector_detail::batch<N>::width != 0;
+
+        N value;
+
+        std::size_t size() const noexcept { return 0; }
+        N element(std::size_t) const noexcept { return value; }
+
+        template<typename Vec>
+        auto load(std::size_t) const noexcept { return Vec::broadcast(value); }
+    };
+
+    // Op applied to the elements of two nodes, with U the unit of the
+    // result. SIMD batches are used when all leaves share one number type.
+    template<typename Op, typename L, typename R, typename U>
+    struct binary_node {
+        using number_type = decltype(Op::apply(std::declval<typename L::number_type>(),
+                                               std::declval<typename R::number_type>()));
+        using unit_type = U;
+        static constexpr bool sized = L::sized or R::sized;
+        static constexpr bool batchable = L::batchable and R::batchable and
+            std::is_same<typename L::number_type, typename R::number_type>::value;
+
+        L left;
+        R right;
+
+        std::size_t size() const noexcept { return L::sized ? left.size() : right.size(); }
+
+        number_type element(std::size_t i) const noexcept {
+            return Op::apply(left.element(i), right.element(i));
+        }
+
+        template<typename Vec>
+        auto load(std::size_t i) const noexcept {
+            return Op::apply(left.template load<Vec>(i), right.template load<Vec>(i));
+        }
+    };
+
+    // Unit of the result of Op, derived like for single quantities.
+    template<typename Op, typename U, typename V>
+    struct result_unit {
+        static_assert(std::is_same<U, V>::value, "Elementwise + and - need operands of the same unit.");
+        using type = U;
+    };
+
+    template<typename U, typename V>
+    struct result_unit<vector_detail::multiply_op, U, V> {
+        using type = number_detail::normalize<decltype(U{} * V{})>;
+    };
+
+    template<typename U, typename V>
+    struct result_unit<vector_detail::divide_op, U, V> {
+        using type = number_detail::normalize<decltype(U{} / V{})>;
+    };
+
+    // Writes the elements of e to out in one pass. e is taken by value so
+    // that the stores to out cannot alias the leaves, which lets the
+    // compiler keep pointers and broadcasts in registers.
+    template<typename E, typename C>
+    void evaluate(const E e, C* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (E::batchable and std::is_same<typename E::number_type, C>::value) {
+            using vec = vector_detail::batch<C>;
+            for (; i + vec::width <= n; i += vec::width) {
+                vec::store(out + i, e.template load<vec>(i));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<C>(e.element(i));
+        }
+    }
+
+} /* namespace expression_detail */
+
+// Lazy elementwise arithmetic on ranges of quantities. An expression holds
+// its operands and the unit of its result in its type, and computes all of
+// its operations in a single loop when assigned to a unit_vector or
+// evaluated, without temporary vectors:
+//
+//     unit_vector<double, metric::energy_u> energy = 0.5 * lazy(mass) * v * v;
+//
+// Expressions refer to the numbers of their ranges, which must outlive them.
+// Temporary unit_vectors are rejected at compile time, but a unit_vector
+// destroyed while an expression of it is still alive is not caught.
+template<typename E>
+class unit_expression {
+public:
+    using node_type = E;
+    using number_type = typename E::number_type;
+    using unit_type = typename E::unit_type;
+    using value_type = unit_number<number_type, unit_type>;
+
+    constexpr explicit unit_expression(const E& node) noexcept : node_(node) {}
+
+    const E& node() const noexcept { return node_; }
+    std::size_t size() const noexcept { return node_.size(); }
+
+    value_type operator[] (std::size_t i) const noexcept {
+        return value_type{node_.element(i)};
+    }
+
+    // Writes the size() elements to out, the numbers of a range with the
+    // unit V.
+    template<typename V, typename C>
+    void evaluate(C* out) const noexcept {
+        static_assert(std::is_same<V, unit_type>::value,
+            "The target of an expression needs the unit of the expression.");
+        static_assert(not std::is_integral<C>::value or std::is_integral<number_type>::value,
+            "Integral targets need an integral expression, so that no result is truncated.");
+        expression_detail::evaluate(node_, out, node_.size());
+    }
+
+private:
+    E node_;
+};
+
+namespace expression_detail {
+
+    template<typename T>
+    struct is_expression : public std::false_type {};
+    template<typename E>
+    struct is_expression<unit_expression<E>> : public std::true_type {};
+
+    template<typename T>
+    struct is_operand {
+        static constexpr bool value = is_expression<T>::value or vector_detail::is_unit_range<T>::value;
+    };
+
+    template<typename E>
+    const E& node_of(const unit_expression<E>& x) noexcept {
+        return x.node();
+    }
+
+    template<typename A, std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>
+    auto node_of(const A& a) noexcept {
+        const auto x = vector_detail::as_span(a);
+        using span_t = decltype(x);
+        return range_leaf<typename span_t::number_type, typename span_t::unit_type>{x.data(), x.size()};
+    }
+
+    // A leaf only points to the numbers of its range, so a temporary
+    // unit_vector, such as the result of an eager operator, would be freed
+    // before the expression is evaluated.
+    template<typename N, typename U>
+    void node_of(unit_vector<N, U>&&) = delete;
+
+    template<typename N, typename U>
+    scalar_leaf<N, U> node_of(const unit_number<N, U>& x) noexcept {
+        return {x.value()};
+    }
+
+    template<typename Op, typename L, typename R>
+    auto combine(const L& left, const R& right) noexcept {
+        assert(not L::sized or not R::sized or left.size() == right.size());
+        using unit_t = typename result_unit<Op, typename L::unit_type, typename R::unit_type>::type;
+        return unit_expression<binary_node<Op, L, R, unit_t>>{{left, right}};
+    }
+
+    // A plain number is a scalar of its own type, so that mixed operations
+    // promote like the eager operators of vector.h.
+    template<typename M>
+    scalar_leaf<M, Scalar> scalar_of(const M& x) noexcept {
+        return {x};
+    }
+
+    template<typename A, typename B>
+    using enable_if_operands = std::enable_if_t<
+        (is_expression<A>::value and is_operand<B>::value) or
+        (is_operand<A>::value and is_expression<B>::value), int>;
+
+    template<typename A, typename M>
+    using enable_if_expression_and_quantity = std::enable_if_t<
+        is_expression<A>::value and number_detail::is_unit_number<M>::value, int>;
+
+    template<typename A, typename M>
+    using enable_if_expression_and_scalar = std::enable_if_t<
+        is_expression<A>::value and number_traits<M>::is_number, int>;
+
+} /* namespace expression_detail */
+
+// Starts a lazy expression on the numbers of a unit_vector or unit_span,
+// which must outlive the expression. Temporary unit_vectors are rejected.
+template<typename A, std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>
+auto lazy(const A& a) noexcept {
+    return unit_expression<decltype(expression_detail::node_of(a))>{expression_detail::node_of(a)};
+}
+
+template<typename N, typename U>
+void lazy(unit_vector<N, U>&&) = delete;
+
+// Operators between an expression and another expression or range. The
+// eager operators of vector.h stay in charge of two ranges. Temporary
+// unit_vectors, such as the result of an eager operator, are rejected like
+// in lazy.
+
+#define UNITS_EXPRESSION_OPERATOR(op, kernel)                                  \
+    template<typename A, typename B, expression_detail::enable_if_operands<A, B> = 0>\
+    auto operator op (const A& a, const B& b) noexcept {                       \
+        return expression_detail::combine<vector_detail::kernel>(              \
+            expression_detail::node_of(a), expression_detail::node_of(b));     \
+    }                                                                          \
+                                                                               \
+    template<typename E, typename N, typename U>                               \
+    void operator op (const unit_expression<E>&, unit_vector<N, U>&&) = delete;\
+                                                                               \
+    template<typename N, typename U, typename E>                               \
+    void operator op (unit_vector<N, U>&&, const unit_expression<E>&) = delete;
+
+#define UNITS_EXPRESSION_PRODUCT_OPERATOR(op, kernel)                          \
+    UNITS_EXPRESSION_OPERATOR(op, kernel)                                      \
+                                                                               \
+    template<typename A, typename M,                                           \
+             expression_detail::enable_if_expression_and_quantity<A, M> = 0>   \
+    auto operator op (const A& a, const M& b) noexcept {                       \
+        return expression_detail::combine<vector_detail::kernel>(              \
+            expression_detail::node_of(a), expression_detail::node_of(b));     \
+    }                                                                          \
+                                                                               \
+    template<typename M, typename B,                                           \
+             expression_detail::enable_if_expression_and_quantity<B, M> = 0>   \
+    auto operator op (const M& a, const B& b) noexcept {                       \
+        return expression_detail::combine<vector_detail::kernel>(              \
+            expression_detail::node_of(a), expression_detail::node_of(b));     \
+    }                                                                          \
+                                                                               \
+    template<typename A, typename M,                                           \
+             expression_detail::enable_if_expression_and_scalar<A, M> = 0>     \
+    auto operator op (const A& a, const M& b) noexcept {                       \
+        return expression_detail::combine<vector_detail::kernel>(              \
+            a.node(), expression_detail::scalar_of(b));                        \
+    }                                                                          \
+                                                                               \
+    template<typename M, typename B,                                           \
+             expression_detail::enable_if_expression_and_scalar<B, M> = 0>     \
+    auto operator op (const M& a, const B& b) noexcept {                       \
+        return expression_detail::combine<vector_detail::kernel>(              \
+            expression_detail::scalar_of(a), b.node());                        \
+    }
+
+UNITS_EXPRESSION_OPERATOR(+, add_op)
+UNITS_EXPRESSION_OPERATOR(-, subtract_op)
+UNITS_EXPRESSION_PRODUCT_OPERATOR(*, multiply_op)
+UNITS_EXPRESSION_PRODUCT_OPERATOR(/, divide_op)
+
+#undef UNITS_EXPRESSION_PRODUCT_OPERATOR
+#undef UNITS_EXPRESSION_OPERATOR
+
+// The elements of e in a new unit_vector.
+template<typename E>
+auto evaluate(const unit_expression<E>& e) {
+    return unit_vector<typename E::number_type, typename E::unit_type>(e);
+}
+
+// Writes the elements of e to out, which must have the unit and size of e.
+template<typename N, typename U, typename E>
+void evaluate(const unit_expression<E>& e, const unit_span<N, U>& out) noexcept {
+    assert(out.size() == e.size());
+    e.template evaluate<U>(out.data());
+}
+
+// In-place accumulation of an expression, in the same single pass.
+
+template<typename A, typename E, std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>
+A& operator+= (A& a, const unit_expression<E>& e) {
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    evaluate(lazy(x) + e, x);
+    return a;
+}
+
+template<typename A, typename E, std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>
+A& operator-= (A& a, const unit_expression<E>& e) {
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    evaluate(lazy(x) - e, x);
+    return a;
+}
+
+namespace expression_detail {
+
+    template<typename T, typename = void>
+    struct can_start : public std::false_type {};
+    template<typename T>
+    struct can_start<T, std::void_t<decltype(lazy(std::declval<T>()))>> : public std::true_type {};
+
+    template<typename A, typename B, typename = void>
+    struct can_add : public std::false_type {};
+    template<typename A, typename B>
+    struct can_add<A, B, std::void_t<decltype(std::declval<A>() + std::declval<B>())>>
+        : public std::true_type {};
+
+    using checked_vector = unit_vector<double, Scalar>;
+    using checked_expression = decltype(lazy(std::declval<const checked_vector&>()));
+
+    static_assert(can_start<checked_vector&>::value and not can_start<checked_vector>::value and
+                  can_add<checked_expression, checked_vector&>::value and
+                  not can_add<checked_expression, checked_vector>::value and
+                  not can_add<checked_vector, checked_expression>::value,
+        "Expressions must not take temporary unit_vectors, whose numbers they would outlive.");
+
+} /* namespace expression_detail */
+
+} /* namespace units */
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef UNITS_FORMAT_H
+#define UNITS_FORMAT_H
+
+#include "number.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+namespace units {
+
+// How the unit after a number is written. name spells out the base units as
+// operator<< does ("meter/second^2"), symbol uses the SI symbols ("m/s^2")
+// and none leaves the unit out.
+enum class unit_style {
+    name,
+    symbol,
+    none
+};
+
+namespace format_detail {
+
+    // Compile time text of the unit U in style, see unit::name.
+    template<typename U>
+    constexpr std::string_view text_of(unit_style style) noexcept {
+        switch (style) {
+        case unit_style::name: return U::name;
+        case unit_style::symbol: return U::symbol;
+        default: return {};
+        }
+    }
+
+    template<typename U>
+    std::to_chars_result unit_to_chars(char* first, char* last, unit_style style) noexcept {
+        const std::string_view text = text_of<U>(style);
+        if (static_cast<std::size_t>(last - first) < text.size()) {
+            return {last, std::errc::value_too_large};
+        }
+        std::memcpy(first, text.data(), text.size());
+        return {first + text.size(), std::errc{}};
+    }
+
+    // Writes the unit after a number that ends at result.ptr.
+    template<typename U>
+    std::to_chars_result append_unit(std::to_chars_result result, char* last, unit_style style) noexcept {
+        if (result.ec != std::errc{} or style == unit_style::none) {
+            return result;
+        }
+        if (result.ptr == last) {
+            return {last, std::errc::value_too_large};
+        }
+        *result.ptr++ = ' ';
+        return unit_to_chars<U>(result.ptr, last, style);
+    }
+
+    // Length of the number spec at the start of a std::format spec of a
+    // quantity, which ends at '}', at the end or at the '|' before the unit
+    // style. A first character followed by an alignment is the fill of the
+    // number, so "|>10" fills with '|'.
+    constexpr std::size_t number_spec_size(std::string_view spec) noexcept {
+        const bool has_fill = spec.size() > 1 and spec[0] != '{' and spec[0] != '}' and
+                              (spec[1] == '<' or spec[1] == '>' or spec[1] == '^');
+        std::size_t i = has_fill ? 2 : 0;
+        while (i < spec.size() and spec[i] != '}' and spec[i] != '|') {
+            ++i;
+        }
+        return i;
+    }
+
+    static_assert(number_spec_size(".2f|s}") == 3 and number_spec_size("|>10}") == 4 and
+                  number_spec_size("|^8|x}") == 3 and number_spec_size("}<2") == 0 and
+                  number_spec_size("|s}") == 0 and number_spec_size("") == 0,
+        "A '|' fill must not be taken for the unit style separator.");
+
+} /* namespace format_detail */
+
+// Copies the text of a unit into [first, last) like std::to_chars: on success
+// ptr is one past the last character written, and when the text does not
+// fit ec is std::errc::value_too_large. Nothing is allocated and no locale
+// is consulted.
+template<typename... DimExps>
+std::to_chars_result to_chars(char* first, char* last, const unit<DimExps...>&,
+                              unit_style style = unit_style::name) noexcept {
+    return format_detail::unit_to_chars<unit<DimExps...>>(first, last, style);
+}
+
+template<typename R, typename U>
+std::to_chars_result to_chars(char* first, char* last, const unit_multiple<R, U>&,
+                              unit_style style = unit_style::name) noexcept {
+    return format_detail::unit_to_chars<unit_multiple<R, U>>(first, last, style);
+}
+
+// Writes "<number> <unit>". The number is the shortest text that reads back
+// to the same value, as with std::to_chars.
+template<typename N, typename U>
+std::to_chars_result to_chars(char* first, char* last, const unit_number<N, U>& x,
+                              unit_style style = unit_style::name) noexcept {
+    return format_detail::append_unit<U>(std::to_chars(first, last, x.value()), last, style);
+}
+
+// As above with the number in fmt, optionally with precision digits.
+template<typename N, typename U>
+std::to_chars_result to_chars(char* first, char* last, const unit_number<N, U>& x,
+                              std::chars_format fmt, unit_style style = unit_style::name) noexcept {
+    static_assert(std::is_floating_point<N>::value, "Only floating point numbers take a format.");
+    return format_detail::append_unit<U>(std::to_chars(first, last, x.value(), fmt), last, style);
+}
+
+template<typename N, typename U>
+std::to_chars_result to_chars(char* first, char* last, const unit_number<N, U>& x,
+                              std::chars_format fmt, int precision,
+                              unit_style style = unit_style::name) noexcept {
+    static_assert(std::is_floating_point<N>::value, "Only floating point numbers take a format.");
+    return format_detail::append_unit<U>(
+        std::to_chars(first, last, x.value(), fmt, precision), last, style);
+}
+
+} /* namespace units */
+
+#ifdef __cpp_lib_format
+
+// std::format support. The format spec of a quantity is the spec of its
+// number, optionally followed by '|' and a unit style: 'n' for names (the
+// default), 's' for symbols or 'x' for no unit. std::format("{:.2f|s}", v)
+// gives "9.81 m/s^2", and '|' may still be the fill, as in "{:|>10|s}".
+// Widths and precisions taken from arguments are not supported in the
+// number spec.
+template<typename N, typename U>
+struct std::formatter<units::unit_number<N, U>, char> {
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto first = ctx.begin();
+        const std::string_view spec(first == ctx.end() ? nullptr : &*first,
+                                    static_cast<std::size_t>(ctx.end() - first));
+        auto last = first + units::format_detail::number_spec_size(spec);
+        auto end = last;
+        if (last != ctx.end() and *last == '|') {
+            ++end;
+            if (end == ctx.end() or *end == '}') {
+                throw std::format_error("Missing unit style after '|'.");
+            }
+            switch (*end++) {
+            case 'n': style_ = units::unit_style::name; break;
+            case 's': style_ = units::unit_style::symbol; break;
+            case 'x': style_ = units::unit_style::none; break;
+            default: throw std::format_error("Unknown unit style.");
+            }
+        }
+        std::format_parse_context number_ctx{std::string_view(
+            first == ctx.end() ? nullptr : &*first, static_cast<std::size_t>(last - first))};
+        number_.parse(number_ctx);
+        return end;
+    }
+
+    template<typename Context>
+    auto format(const units::unit_number<N, U>& x, Context& ctx) const {
+        auto out = number_.format(x.value(), ctx);
+        if (style_ != units::unit_style::none) {
+            *out++ = ' ';
+            const std::string_view text = units::format_detail::text_of<U>(style_);
+            out = std::copy(text.begin(), text.end(), out);
+        }
+        return out;
+    }
+
+private:
+    std::formatter<N, char> number_;
+    units::unit_style style_ = units::unit_style::name;
+};
+
+#endif
+
+#endif
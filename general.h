@@ -3,24 +3,70 @@
 
 #include "number.h"
 
+#include <chrono>
+
 namespace units {
 
 DEFINE_DIMENSION(time, second);
-const auto minute = std::ratio<60, 1>{} * second;
-const auto hour   = std::ratio<60, 1>{} * minute;
-const auto day    = std::ratio<24, 1>{} * hour;
-const auto week   = std::ratio<7, 1>{} * day;
-const auto fortnight = std::ratio<2, 1>{} * week;
-const auto year   = std::ratio<365, 1>{} * day;
-
-const auto attosecond  = std::atto{} * second;
-const auto femtosecond = std::femto{} * second;
-const auto picosecond  = std::pico{} * second;
-const auto nanosecond  = std::nano{} * second;
-const auto microsecond = std::micro{} * second;
-const auto millisecond = std::milli{} * second;
-const auto centisecond = std::centi{} * second;
-const auto decisecond  = std::deci{} * second;
+inline constexpr auto minute = std::ratio<60, 1>{} * second;
+inline constexpr auto hour   = std::ratio<60, 1>{} * minute;
+inline constexpr auto day    = std::ratio<24, 1>{} * hour;
+inline constexpr auto week   = std::ratio<7, 1>{} * day;
+inline constexpr auto fortnight = std::ratio<2, 1>{} * week;
+inline constexpr auto year   = std::ratio<365, 1>{} * day;
+
+inline constexpr auto attosecond  = std::atto{} * second;
+inline constexpr auto femtosecond = std::femto{} * second;
+inline constexpr auto picosecond  = std::pico{} * second;
+inline constexpr auto nanosecond  = std::nano{} * second;
+inline constexpr auto microsecond = std::micro{} * second;
+inline constexpr auto millisecond = std::milli{} * second;
+inline constexpr auto centisecond = std::centi{} * second;
+inline constexpr auto decisecond  = std::deci{} * second;
+
+// Conversions to and from std::chrono durations. The period of the duration
+// is the scale of the time quantity, so matching periods only copy the
+// count and other periods rescale it with a single constant factor.
+
+template<typename Rep, typename Period>
+constexpr auto from_chrono(const std::chrono::duration<Rep, Period>& d) noexcept {
+    using U = number_detail::scaled_unit<typename Period::type, time_u>;
+    return make_unit_number<U>(d.count());
+}
+
+template<typename N, typename U>
+constexpr auto to_chrono(const unit_number<N, U>& x) noexcept {
+    static_assert(number_detail::same_base<U, time_u>::value,
+        "Only time quantities convert to std::chrono durations.");
+    return std::chrono::duration<N, number_detail::scale_of<U>>{x.value()};
+}
+
+template<typename Duration, typename N, typename U>
+constexpr Duration to_chrono(const unit_number<N, U>& x) noexcept {
+    static_assert(number_detail::same_base<U, time_u>::value,
+        "Only time quantities convert to std::chrono durations.");
+    using R = std::ratio_divide<number_detail::scale_of<U>, typename Duration::period>;
+    using Rep = typename Duration::rep;
+    return Duration{number_detail::rescale<R, Rep>(x.value())};
+}
+
+namespace literals {
+
+DEFINE_UNIT_LITERAL(s,   second)
+DEFINE_UNIT_LITERAL(min, minute)
+DEFINE_UNIT_LITERAL(h,   hour)
+DEFINE_UNIT_LITERAL(d,   day)
+
+DEFINE_UNIT_LITERAL(as,  attosecond)
+DEFINE_UNIT_LITERAL(fs,  femtosecond)
+DEFINE_UNIT_LITERAL(ps,  picosecond)
+DEFINE_UNIT_LITERAL(ns,  nanosecond)
+DEFINE_UNIT_LITERAL(us,  microsecond)
+DEFINE_UNIT_LITERAL(ms,  millisecond)
+DEFINE_UNIT_LITERAL(cs,  centisecond)
+DEFINE_UNIT_LITERAL(ds,  decisecond)
+
+} /* namespace literals */
 
 } /* namespace units */
 
@@ -1,19 +1,20 @@
 #include "metric.h"
 #include "us.h"
+#include <iostream>
 
 using namespace std;
 using namespace units;
 using namespace units::metric;
 
-area<double> get_area(dist<double> width, dist<double> height) {
+constexpr area<double> get_area(dist<double> width, dist<double> height) {
     return width * height;
 }
 
-velocity<double> get_speed(acceleration<double> accel, time<double> elapsed) {
+constexpr velocity<double> get_speed(acceleration<double> accel, units::time<double> elapsed) {
     return accel * elapsed;
 }
 
-frequency<double> get_frequency(time<double> x) {
+constexpr frequency<double> get_frequency(units::time<double> x) {
     return scalar_double{1.0} / x;
 }
 
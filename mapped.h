@@ -0,0 +1,278 @@
+#ifndef UNITS_MAPPED_H
+#define UNITS_MAPPED_H
+
+#include "number.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "mapped.h needs POSIX mmap."
+#endif
+
+namespace units {
+
+// Outcome of reading or writing a mapped array. io_error leaves the cause in
+// errno, the mismatch codes mean the file holds numbers of another type,
+// unit or scale than asked for.
+enum class mapped_errc {
+    ok,
+    io_error,
+    truncated,
+    bad_header,
+    number_mismatch,
+    unit_mismatch,
+    scale_mismatch
+};
+
+// Fixed 64 byte header in front of the raw numbers. The numbers start at
+// data_offset, a multiple of alignment, and are stored in the byte order of
+// the writer, which the reader must share.
+struct mapped_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint8_t number_kind;
+    std::uint8_t number_size;
+    std::uint16_t reserved;
+    std::uint32_t alignment;
+    std::uint64_t fingerprint;
+    std::int64_t scale_num;
+    std::int64_t scale_den;
+    std::uint64_t count;
+    std::uint64_t data_offset;
+};
+
+static_assert(sizeof(mapped_header) == 64, "mapped_header must not be padded.");
+
+namespace mapped_detail {
+
+    constexpr char magic[8] = {'U', 'N', 'I', 'T', 'A', 'R', 'R', '\0'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t byte_order = 0x01020304;
+    constexpr std::size_t default_alignment = 64;
+
+    enum number_kind : std::uint8_t {
+        signed_integer = 1,
+        unsigned_integer = 2,
+        floating_point = 3
+    };
+
+    template<typename N>
+    constexpr std::uint8_t kind_of() noexcept {
+        static_assert(std::is_arithmetic<N>::value and not std::is_same<N, bool>::value,
+            "Only arithmetic numbers can be mapped.");
+        return std::is_floating_point<N>::value ? floating_point
+             : std::is_signed<N>::value ? signed_integer : unsigned_integer;
+    }
+
+    // Identity of the dimensions and exponents of U, ignoring its scale.
+    template<typename U>
+    constexpr std::uint64_t signature = number_detail::base_unit_of<U>::fingerprint;
+
+    template<typename N, typename U>
+    mapped_header make_header(std::size_t count, std::size_t alignment) noexcept {
+        using scale = number_detail::scale_of<U>;
+        mapped_header h{};
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version = version;
+        h.byte_order = byte_order;
+        h.number_kind = kind_of<N>();
+        h.number_size = sizeof(N);
+        h.alignment = static_cast<std::uint32_t>(alignment);
+        h.fingerprint = signature<U>;
+        h.scale_num = scale::num;
+        h.scale_den = scale::den;
+        h.count = count;
+        h.data_offset = (sizeof(mapped_header) + alignment - 1) / alignment * alignment;
+        return h;
+    }
+
+    template<typename N, typename U>
+    mapped_errc check_header(const mapped_header& h, std::size_t file_size) noexcept {
+        using scale = number_detail::scale_of<U>;
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0 or h.version != version or
+            h.byte_order != byte_order or h.alignment == 0 or
+            h.data_offset < sizeof(mapped_header) or h.data_offset % alignof(N) != 0) {
+            return mapped_errc::bad_header;
+        }
+        if (h.number_kind != kind_of<N>() or h.number_size != sizeof(N)) {
+            return mapped_errc::number_mismatch;
+        }
+        if (h.fingerprint != signature<U>) {
+            return mapped_errc::unit_mismatch;
+        }
+        if (h.scale_num != scale::num or h.scale_den != scale::den) {
+            return mapped_errc::scale_mismatch;
+        }
+        if (h.data_offset > file_size or h.count > (file_size - h.data_offset) / sizeof(N)) {
+            return mapped_errc::truncated;
+        }
+        return mapped_errc::ok;
+    }
+
+    inline bool write_all(int fd, const void* data, std::size_t size) noexcept {
+        const char* p = static_cast<const char*>(data);
+        while (size != 0) {
+            const ::ssize_t n = ::write(fd, p, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+} /* namespace mapped_detail */
+
+// Read only view of the numbers of a mapped file, which stays mapped for
+// the lifetime of the object.
+template<typename N, typename U>
+class mapped_array {
+public:
+    using span_type = unit_span<const N, U>;
+
+    mapped_array() noexcept = default;
+
+    mapped_array(const mapped_array&) = delete;
+    mapped_array& operator= (const mapped_array&) = delete;
+
+    mapped_array(mapped_array&& x) noexcept
+        : base_(x.base_), length_(x.length_), data_(x.data_), size_(x.size_) {
+        x.release();
+    }
+
+    mapped_array& operator= (mapped_array&& x) noexcept {
+        if (this != &x) {
+            unmap();
+            base_ = x.base_;
+            length_ = x.length_;
+            data_ = x.data_;
+            size_ = x.size_;
+            x.release();
+        }
+        return *this;
+    }
+
+    ~mapped_array() { unmap(); }
+
+    const N* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    span_type span() const noexcept { return span_type{data_, size_}; }
+
+    template<typename M, typename V>
+    friend mapped_errc map_array(const char* path, mapped_array<M, V>& out) noexcept;
+
+private:
+    void release() noexcept {
+        base_ = nullptr;
+        length_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void unmap() noexcept {
+        if (base_) {
+            ::munmap(base_, length_);
+        }
+        release();
+    }
+
+    void* base_ = nullptr;
+    std::size_t length_ = 0;
+    const N* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Writes the header and the numbers of values to path, replacing the file.
+// alignment is the offset granularity of the numbers in the file and must
+// be a power of two no smaller than the alignment of N.
+template<typename N, typename U>
+mapped_errc write_array(const char* path, const unit_span<N, U>& values,
+                        std::size_t alignment = mapped_detail::default_alignment) noexcept {
+    using number_t = std::remove_cv_t<N>;
+    assert(alignment != 0 and (alignment & (alignment - 1)) == 0 and alignment >= alignof(number_t));
+    const mapped_header h = mapped_detail::make_header<number_t, U>(values.size(), alignment);
+
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return mapped_errc::io_error;
+    }
+    constexpr char padding[mapped_detail::default_alignment] = {};
+    std::size_t gap = h.data_offset - sizeof(h);
+    bool ok = mapped_detail::write_all(fd, &h, sizeof(h));
+    while (ok and gap != 0) {
+        const std::size_t n = gap < sizeof(padding) ? gap : sizeof(padding);
+        ok = mapped_detail::write_all(fd, padding, n);
+        gap -= n;
+    }
+    ok = ok and mapped_detail::write_all(fd, values.data(), values.size() * sizeof(number_t));
+    ok = ::close(fd) == 0 and ok;
+    return ok ? mapped_errc::ok : mapped_errc::io_error;
+}
+
+template<typename N, typename U>
+mapped_errc write_array(const char* path, const unit_vector<N, U>& values,
+                        std::size_t alignment = mapped_detail::default_alignment) noexcept {
+    return write_array(path, values.span(), alignment);
+}
+
+// Maps the file at path and checks its header against unit_number<N, U>.
+// On success out views the numbers in place, nothing is copied or parsed.
+// On failure out is left empty.
+template<typename N, typename U>
+mapped_errc map_array(const char* path, mapped_array<N, U>& out) noexcept {
+    out.unmap();
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return mapped_errc::io_error;
+    }
+    struct ::stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return mapped_errc::io_error;
+    }
+    const std::size_t length = static_cast<std::size_t>(info.st_size);
+    if (length < sizeof(mapped_header)) {
+        ::close(fd);
+        return mapped_errc::truncated;
+    }
+    void* base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return mapped_errc::io_error;
+    }
+
+    mapped_header h;
+    std::memcpy(&h, base, sizeof(h));
+    const mapped_errc ec = mapped_detail::check_header<N, U>(h, length);
+    if (ec != mapped_errc::ok) {
+        ::munmap(base, length);
+        return ec;
+    }
+    out.base_ = base;
+    out.length_ = length;
+    out.data_ = reinterpret_cast<const N*>(static_cast<const char*>(base) + h.data_offset);
+    out.size_ = static_cast<std::size_t>(h.count);
+    return mapped_errc::ok;
+}
+
+} /* namespace units */
+
+#endif
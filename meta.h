@@ -35,19 +35,70 @@ using rebind = typename ::units::meta::detail::rebind_impl<Y, List>::type;
 
 template<template<typename> class Predicate, typename List> struct all;
 template<template<typename> class Predicate,
-         template<typename...> class X,
-         typename Head, typename... Tail>
-struct all<Predicate, X<Head, Tail...>> {
-    static constexpr bool value = Predicate<Head>::value and all<Predicate, X<Tail...>>::value;
+         template<typename...> class X, typename... Args>
+struct all<Predicate, X<Args...>> {
+    static constexpr bool value = (true and ... and Predicate<Args>::value);
 };
 
-template<template<typename> class Predicate, template<typename...> class X, typename Head>
-struct all<Predicate, X<Head>> {
-    static constexpr bool value = Predicate<Head>::value;
+// All Adjacent
+
+namespace detail {
+
+    struct end_of_list {};
+
+    template<template<typename, typename> class Relation, typename First, typename Second>
+    struct adjacent_holds {
+        static constexpr bool value = Relation<First, Second>::value;
+    };
+    template<template<typename, typename> class Relation, typename Last>
+    struct adjacent_holds<Relation, Last, end_of_list> : public std::true_type {};
+
+    template<template<typename, typename> class Relation, typename Firsts, typename Seconds>
+    struct all_adjacent_impl;
+    template<template<typename, typename> class Relation,
+             typename... Firsts, typename... Seconds>
+    struct all_adjacent_impl<Relation, type_list<Firsts...>, type_list<Seconds...>> {
+        static constexpr bool value =
+            (true and ... and adjacent_holds<Relation, Firsts, Seconds>::value);
+    };
+
+} /* namespace detail */
+
+// Checks Relation<Arg[i], Arg[i + 1]> for every neighbouring pair with a
+// single fold instead of one nested instantiation per element.
+template<template<typename, typename> class Relation, typename List> struct all_adjacent;
+template<template<typename, typename> class Relation,
+         template<typename...> class X, typename First, typename... Rest>
+struct all_adjacent<Relation, X<First, Rest...>> {
+    static constexpr bool value = ::units::meta::detail::all_adjacent_impl<Relation,
+        type_list<First, Rest...>, type_list<Rest..., ::units::meta::detail::end_of_list>
+    >::value;
 };
+template<template<typename, typename> class Relation, template<typename...> class X>
+struct all_adjacent<Relation, X<>> : public std::true_type {};
 
-template<template<typename> class Predicate, template<typename...> class X>
-struct all<Predicate, X<>> : public std::true_type {};
+// Index of
+
+namespace detail {
+
+    template<typename T, typename... Args>
+    constexpr std::size_t index_of_impl() {
+        constexpr bool matches[] = {std::is_same<T, Args>::value..., false};
+        std::size_t i = 0;
+        while (i < sizeof...(Args) and not matches[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+} /* namespace detail */
+
+// Position of the first T in List, or the size of List if T is not in it.
+template<typename T, typename List> struct index_of;
+template<typename T, template<typename...> class X, typename... Args>
+struct index_of<T, X<Args...>> {
+    static constexpr std::size_t value = ::units::meta::detail::index_of_impl<T, Args...>();
+};
 
 // Lexicographical compare
 
@@ -283,37 +334,147 @@ using sort = typename ::units::meta::detail::sort_impl<Less, List>::type;
 
 // Is sorted
 
-template<template<typename, typename> class Less, typename List> struct is_sorted;
-template<template<typename, typename> class Less,
-         template<typename...> class X,
-         typename First, typename Second, typename... Rest>
-struct is_sorted<Less, X<First, Second, Rest...>> {
-    static constexpr bool value = !Less<Second, First>::value
-        and is_sorted<Less, X<Second, Rest...>>::value;
+namespace detail {
+
+    template<template<typename, typename> class Less>
+    struct not_descending {
+        template<typename First, typename Second>
+        struct action {
+            static constexpr bool value = !Less<Second, First>::value;
+        };
+    };
+
+    template<template<typename, typename> class Equal>
+    struct not_equal {
+        template<typename First, typename Second>
+        struct action {
+            static constexpr bool value = !Equal<First, Second>::value;
+        };
+    };
+
+} /* namespace detail */
+
+template<template<typename, typename> class Less, typename List>
+struct is_sorted {
+    static constexpr bool value = all_adjacent<
+        ::units::meta::detail::not_descending<Less>::template action, List
+    >::value;
 };
-template<template<typename, typename> class Less,
-         template<typename...> class X, typename Arg>
-struct is_sorted<Less, X<Arg>> : public std::true_type {};
-template<template<typename, typename> class Less,
-         template<typename...> class X>
-struct is_sorted<Less, X<>> : public std::true_type {};
 
 // Is Unique
 
-template<template<typename, typename> class Equal, typename List> struct is_unique;
-template<template<typename, typename> class Equal,
-         template<typename...> class X,
-         typename First, typename Second, typename... Rest>
-struct is_unique<Equal, X<First, Second, Rest...>> {
-    static constexpr bool value = !Equal<First, Second>::value
-        and is_unique<Equal, X<Second, Rest...>>::value;
+template<template<typename, typename> class Equal, typename List>
+struct is_unique {
+    static constexpr bool value = all_adjacent<
+        ::units::meta::detail::not_equal<Equal>::template action, List
+    >::value;
 };
-template<template<typename, typename> class Equal,
-         template<typename...> class X, typename Arg>
-struct is_unique<Equal, X<Arg>> : public std::true_type {};
-template<template<typename, typename> class Equal,
-         template<typename...> class X>
-struct is_unique<Equal, X<>> : public std::true_type {};
+
+// Merge
+
+namespace detail {
+
+    template<typename List> struct empty_impl;
+    template<template<typename...> class X, typename... Args>
+    struct empty_impl<X<Args...>> {
+        using type = X<>;
+    };
+
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             typename Left, typename Right, typename Result>
+    struct merge_impl;
+
+    template<int order,
+             template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             typename Left, typename Right, typename Result>
+    struct merge_step;
+
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename LHead, typename... LTail,
+             typename RHead, typename... RTail,
+             typename... Result>
+    struct merge_impl<Less, Combine, Keep,
+                      X<LHead, LTail...>, X<RHead, RTail...>, X<Result...>> {
+        using type = typename merge_step<
+            Less<LHead, RHead>::value ? -1 : (Less<RHead, LHead>::value ? 1 : 0),
+            Less, Combine, Keep,
+            X<LHead, LTail...>, X<RHead, RTail...>, X<Result...>
+        >::type;
+    };
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename... Left, typename... Result>
+    struct merge_impl<Less, Combine, Keep, X<Left...>, X<>, X<Result...>> {
+        using type = X<Result..., Left...>;
+    };
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename RHead, typename... RTail, typename... Result>
+    struct merge_impl<Less, Combine, Keep, X<>, X<RHead, RTail...>, X<Result...>> {
+        using type = X<Result..., RHead, RTail...>;
+    };
+
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename LHead, typename... LTail,
+             typename Right, typename... Result>
+    struct merge_step<-1, Less, Combine, Keep, X<LHead, LTail...>, Right, X<Result...>> {
+        using type = typename merge_impl<Less, Combine, Keep,
+            X<LTail...>, Right, X<Result..., LHead>>::type;
+    };
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename Left, typename RHead, typename... RTail,
+             typename... Result>
+    struct merge_step<1, Less, Combine, Keep, Left, X<RHead, RTail...>, X<Result...>> {
+        using type = typename merge_impl<Less, Combine, Keep,
+            Left, X<RTail...>, X<Result..., RHead>>::type;
+    };
+    template<template<typename, typename> class Less,
+             template<typename, typename> class Combine,
+             template<typename> class Keep,
+             template<typename...> class X,
+             typename LHead, typename... LTail,
+             typename RHead, typename... RTail,
+             typename... Result>
+    struct merge_step<0, Less, Combine, Keep,
+                      X<LHead, LTail...>, X<RHead, RTail...>, X<Result...>> {
+    private:
+        using combined = Combine<LHead, RHead>;
+        using result = static_if<Keep<combined>::value,
+            X<Result..., combined>, X<Result...>>;
+    public:
+        using type = typename merge_impl<Less, Combine, Keep,
+            X<LTail...>, X<RTail...>, result>::type;
+    };
+
+} /* namespace detail */
+
+// Merges two lists sorted by Less in a single linear pass. Elements that
+// compare equal are replaced by Combine<L, R> and only kept if Keep holds.
+template<template<typename, typename> class Less,
+         template<typename, typename> class Combine,
+         template<typename> class Keep,
+         typename Left, typename Right>
+using merge = typename ::units::meta::detail::merge_impl<
+    Less, Combine, Keep, Left, Right,
+    typename ::units::meta::detail::empty_impl<Left>::type
+>::type;
 
 // Intersection
 
@@ -14,29 +14,54 @@ namespace detail {
 #define UNIT_TYPE(x) unit_type<decltype(x)>
 
 #define SI_SMALLER_PREFIXES(base)                                              \
-    const auto atto##base  = std::atto{} * base;                               \
-    const auto femto##base = std::femto{} * base;                              \
-    const auto pico##base  = std::pico{} * base;                               \
-    const auto nano##base  = std::nano{} * base;                               \
-    const auto micro##base = std::micro{} * base;                              \
-    const auto milli##base = std::milli{} * base;                              \
-    const auto centi##base = std::centi{} * base;                              \
-    const auto deci##base  = std::deci{} * base;
+    inline constexpr auto atto##base  = std::atto{} * base;                    \
+    inline constexpr auto femto##base = std::femto{} * base;                   \
+    inline constexpr auto pico##base  = std::pico{} * base;                    \
+    inline constexpr auto nano##base  = std::nano{} * base;                    \
+    inline constexpr auto micro##base = std::micro{} * base;                   \
+    inline constexpr auto milli##base = std::milli{} * base;                   \
+    inline constexpr auto centi##base = std::centi{} * base;                   \
+    inline constexpr auto deci##base  = std::deci{} * base;
 
 #define SI_LARGER_PREFIXES(base)                                               \
-    const auto deca##base  = std::deca{} * base;                               \
-    const auto hecto##base = std::hecto{} * base;                              \
-    const auto kilo##base  = std::kilo{} * base;                               \
-    const auto mega##base  = std::mega{} * base;                               \
-    const auto giga##base  = std::giga{} * base;                               \
-    const auto tera##base  = std::tera{} * base;                               \
-    const auto peta##base  = std::peta{} * base;                               \
-    const auto exa##base   = std::exa{} * base;
+    inline constexpr auto deca##base  = std::deca{} * base;                    \
+    inline constexpr auto hecto##base = std::hecto{} * base;                   \
+    inline constexpr auto kilo##base  = std::kilo{} * base;                    \
+    inline constexpr auto mega##base  = std::mega{} * base;                    \
+    inline constexpr auto giga##base  = std::giga{} * base;                    \
+    inline constexpr auto tera##base  = std::tera{} * base;                    \
+    inline constexpr auto peta##base  = std::peta{} * base;                    \
+    inline constexpr auto exa##base   = std::exa{} * base;
 
 #define SI_ALL_PREFIXES(base)                                                  \
     SI_SMALLER_PREFIXES(base)                                                  \
     SI_LARGER_PREFIXES(base)                                                   \
 
+#define SI_SMALLER_PREFIX_LITERALS(symbol, base)                               \
+    DEFINE_UNIT_LITERAL(a##symbol, metric::atto##base)                         \
+    DEFINE_UNIT_LITERAL(f##symbol, metric::femto##base)                        \
+    DEFINE_UNIT_LITERAL(p##symbol, metric::pico##base)                         \
+    DEFINE_UNIT_LITERAL(n##symbol, metric::nano##base)                         \
+    DEFINE_UNIT_LITERAL(u##symbol, metric::micro##base)                        \
+    DEFINE_UNIT_LITERAL(m##symbol, metric::milli##base)                        \
+    DEFINE_UNIT_LITERAL(c##symbol, metric::centi##base)                        \
+    DEFINE_UNIT_LITERAL(d##symbol, metric::deci##base)
+
+#define SI_LARGER_PREFIX_LITERALS(symbol, base)                                \
+    DEFINE_UNIT_LITERAL(da##symbol, metric::deca##base)                        \
+    DEFINE_UNIT_LITERAL(h##symbol, metric::hecto##base)                        \
+    DEFINE_UNIT_LITERAL(k##symbol, metric::kilo##base)                         \
+    DEFINE_UNIT_LITERAL(M##symbol, metric::mega##base)                         \
+    DEFINE_UNIT_LITERAL(G##symbol, metric::giga##base)                         \
+    DEFINE_UNIT_LITERAL(T##symbol, metric::tera##base)                         \
+    DEFINE_UNIT_LITERAL(P##symbol, metric::peta##base)                         \
+    DEFINE_UNIT_LITERAL(E##symbol, metric::exa##base)
+
+#define SI_ALL_PREFIX_LITERALS(symbol, base)                                   \
+    DEFINE_UNIT_LITERAL(symbol, metric::base)                                  \
+    SI_SMALLER_PREFIX_LITERALS(symbol, base)                                   \
+    SI_LARGER_PREFIX_LITERALS(symbol, base)
+
 ////////////////////////////////// BASE UNITS //////////////////////////////////
 
 // Length
@@ -47,24 +72,24 @@ SI_ALL_PREFIXES(meter);
 // Mass
 
 DEFINE_DIMENSION(mass, kilogram);
-const auto gram = std::milli{} * kilogram;
-
-const auto femtogram = std::femto{} * gram;
-const auto picogram  = std::pico{} * gram;
-const auto nanogram  = std::nano{} * gram;
-const auto microgram = std::micro{} * gram;
-const auto milligram = std::milli{} * gram;
-const auto centigram = std::centi{} * gram;
-const auto decigram  = std::deci{} * gram;
-
-const auto decagram  = std::deca{} * gram;
-const auto hectogram = std::hecto{} * gram;
-const auto megagram  = std::mega{} * gram;
-const auto gigagram  = std::giga{} * gram;
-const auto teragram  = std::tera{} * gram;
-const auto petagram  = std::peta{} * gram;
-const auto exagram   = std::exa{} * gram;
-const auto tonne     = megagram;
+inline constexpr auto gram = std::milli{} * kilogram;
+
+inline constexpr auto femtogram = std::femto{} * gram;
+inline constexpr auto picogram  = std::pico{} * gram;
+inline constexpr auto nanogram  = std::nano{} * gram;
+inline constexpr auto microgram = std::micro{} * gram;
+inline constexpr auto milligram = std::milli{} * gram;
+inline constexpr auto centigram = std::centi{} * gram;
+inline constexpr auto decigram  = std::deci{} * gram;
+
+inline constexpr auto decagram  = std::deca{} * gram;
+inline constexpr auto hectogram = std::hecto{} * gram;
+inline constexpr auto megagram  = std::mega{} * gram;
+inline constexpr auto gigagram  = std::giga{} * gram;
+inline constexpr auto teragram  = std::tera{} * gram;
+inline constexpr auto petagram  = std::peta{} * gram;
+inline constexpr auto exagram   = std::exa{} * gram;
+inline constexpr auto tonne     = megagram;
 
 // Temperature
 
@@ -85,146 +110,210 @@ DEFINE_DIMENSION(substance, mole);
 // Angle
 
 DEFINE_DIMENSION(angle, radian);
-const auto degree =  detail::pi{} * (std::ratio<1, 180>{} * radian);
+inline constexpr auto degree =  detail::pi{} * (std::ratio<1, 180>{} * radian);
 
 //////////////////////////////// DERIVED UNITS /////////////////////////////////
 
 // Area
 
-const auto square_meter = meter * meter;
+inline constexpr auto square_meter = meter * meter;
 SETUP_UNIT_TYPES(area, square_meter);
 
 // Volume
 
-const auto cubic_meter = meter * meter * meter;
+inline constexpr auto cubic_meter = meter * meter * meter;
 SETUP_UNIT_TYPES(volume, cubic_meter);
-const auto liter = std::milli{} * cubic_meter;
+inline constexpr auto liter = std::milli{} * cubic_meter;
 
-const auto femtoliter = std::femto{} * liter;
-const auto picoliter  = std::pico{} * liter;
-const auto nanoliter  = std::nano{} * liter;
-const auto microliter = std::micro{} * liter;
-const auto milliliter = std::milli{} * liter;
-const auto centiliter = std::centi{} * liter;
-const auto deciliter  = std::deci{} * liter;
+inline constexpr auto femtoliter = std::femto{} * liter;
+inline constexpr auto picoliter  = std::pico{} * liter;
+inline constexpr auto nanoliter  = std::nano{} * liter;
+inline constexpr auto microliter = std::micro{} * liter;
+inline constexpr auto milliliter = std::milli{} * liter;
+inline constexpr auto centiliter = std::centi{} * liter;
+inline constexpr auto deciliter  = std::deci{} * liter;
 
 SI_LARGER_PREFIXES(liter);
 
 // Velocity
 
-const auto mps = meter / second;
+inline constexpr auto mps = meter / second;
 SETUP_UNIT_TYPES(velocity, mps);
 
 // Acceleration
 
-const auto mps2 = mps / second;
+inline constexpr auto mps2 = mps / second;
 SETUP_UNIT_TYPES(acceleration, mps2);
-const auto kph = kilometer / hour;
-const auto gravity = 9.80665 * mps2;
+inline constexpr auto kph = kilometer / hour;
+inline constexpr auto gravity = 9.80665 * mps2;
 
 // Frequency
 
-const auto hertz = second.exp<-1>();
+inline constexpr auto hertz = second.exp<-1>();
 SETUP_UNIT_TYPES(frequency, hertz);
 SI_ALL_PREFIXES(hertz);
 
 // Force
 
-const auto newton = kilogram * meter / (second * second);
+inline constexpr auto newton = kilogram * meter / (second * second);
 SETUP_UNIT_TYPES(force, newton);
 SI_ALL_PREFIXES(newton);
 
 // Pressure
 
-const auto pascal = newton / (meter * meter);
+inline constexpr auto pascal = newton / (meter * meter);
 SETUP_UNIT_TYPES(pressure, pascal);
 SI_ALL_PREFIXES(pascal);
 
 // Energy
 
-const auto joule = newton * meter;
+inline constexpr auto joule = newton * meter;
 SETUP_UNIT_TYPES(energy, joule);
 SI_ALL_PREFIXES(joule);
 
 // Power
 
-const auto watt = joule / second;
+inline constexpr auto watt = joule / second;
 SETUP_UNIT_TYPES(power, watt);
 SI_ALL_PREFIXES(watt);
 
 // Electric charge
 
-const auto coloumb = ampere * second;
+inline constexpr auto coloumb = ampere * second;
 SETUP_UNIT_TYPES(electric_charge, coloumb);
 SI_ALL_PREFIXES(coloumb);
 
 // Voltage
 
-const auto volt = watt / ampere;
+inline constexpr auto volt = watt / ampere;
 SETUP_UNIT_TYPES(voltage, volt);
 SI_ALL_PREFIXES(volt);
 
 // Electric capacitance
 
-const auto farad = coloumb / volt;
+inline constexpr auto farad = coloumb / volt;
 SETUP_UNIT_TYPES(electric_capacitance, farad);
 SI_ALL_PREFIXES(farad);
 
 // Electric resistance
 
-const auto ohm = volt / ampere;
+inline constexpr auto ohm = volt / ampere;
 SETUP_UNIT_TYPES(electric_resistance, ohm);
 SI_ALL_PREFIXES(ohm);
 
 // Electrical conductance
 
-const auto siemens = ampere / volt;
+inline constexpr auto siemens = ampere / volt;
 SETUP_UNIT_TYPES(electrical_conductance, siemens);
 SI_ALL_PREFIXES(siemens);
 
 // Magnetic flux
 
-const auto weber = volt * second;
+inline constexpr auto weber = volt * second;
 SETUP_UNIT_TYPES(magnetic_flux, weber);
 SI_ALL_PREFIXES(weber);
 
 // Magnetic field strength
 
-const auto tesla = weber / meter.exp<2>();
+inline constexpr auto tesla = weber / meter.exp<2>();
 SETUP_UNIT_TYPES(magnetic_field, tesla);
 SI_ALL_PREFIXES(tesla);
 
 // Inductance
 
-const auto henry = weber / ampere;
+inline constexpr auto henry = weber / ampere;
 SETUP_UNIT_TYPES(inductance, henry);
 SI_ALL_PREFIXES(henry);
 
 // Radioactivity
 
-const auto becquerel = hertz;
+inline constexpr auto becquerel = hertz;
 SETUP_UNIT_TYPES(radioactivity, becquerel);
 SI_ALL_PREFIXES(becquerel);
 
 // Absorbed dose (of ionizing radiation)
 
-const auto gray = joule / kilogram;
+inline constexpr auto gray = joule / kilogram;
 SETUP_UNIT_TYPES(absorbed_dose, gray);
 SI_ALL_PREFIXES(gray);
 
 // Equivalent dose (of ionizing radiation) J/kg    m2⋅s−2
 
-const auto sievert = joule / kilogram;
+inline constexpr auto sievert = joule / kilogram;
 SETUP_UNIT_TYPES(equivalent_dose, sievert);
 SI_ALL_PREFIXES(sievert);
 
 // Catalytic activity
 
-const auto katal = mole / second;
+inline constexpr auto katal = mole / second;
 SETUP_UNIT_TYPES(catalytic_activity, katal);
 SI_ALL_PREFIXES(katal);
 
 } /* namespace metric */
+
+namespace literals {
+
+SI_ALL_PREFIX_LITERALS(m, meter)
+
+DEFINE_UNIT_LITERAL(kg, metric::kilogram)
+DEFINE_UNIT_LITERAL(g,  metric::gram)
+DEFINE_UNIT_LITERAL(fg, metric::femtogram)
+DEFINE_UNIT_LITERAL(pg, metric::picogram)
+DEFINE_UNIT_LITERAL(ng, metric::nanogram)
+DEFINE_UNIT_LITERAL(ug, metric::microgram)
+DEFINE_UNIT_LITERAL(mg, metric::milligram)
+DEFINE_UNIT_LITERAL(cg, metric::centigram)
+DEFINE_UNIT_LITERAL(dg, metric::decigram)
+DEFINE_UNIT_LITERAL(dag, metric::decagram)
+DEFINE_UNIT_LITERAL(hg, metric::hectogram)
+DEFINE_UNIT_LITERAL(Mg, metric::megagram)
+DEFINE_UNIT_LITERAL(Gg, metric::gigagram)
+DEFINE_UNIT_LITERAL(Tg, metric::teragram)
+DEFINE_UNIT_LITERAL(Pg, metric::petagram)
+DEFINE_UNIT_LITERAL(Eg, metric::exagram)
+DEFINE_UNIT_LITERAL(t,  metric::tonne)
+
+DEFINE_UNIT_LITERAL(K,   metric::kelvin)
+DEFINE_UNIT_LITERAL(A,   metric::ampere)
+DEFINE_UNIT_LITERAL(cd,  metric::candela)
+DEFINE_UNIT_LITERAL(mol, metric::mole)
+DEFINE_UNIT_LITERAL(rad, metric::radian)
+DEFINE_UNIT_LITERAL(deg, metric::degree)
+
+DEFINE_UNIT_LITERAL(m2,   metric::square_meter)
+DEFINE_UNIT_LITERAL(m3,   metric::cubic_meter)
+DEFINE_UNIT_LITERAL(L,    metric::liter)
+DEFINE_UNIT_LITERAL(fL,   metric::femtoliter)
+DEFINE_UNIT_LITERAL(pL,   metric::picoliter)
+DEFINE_UNIT_LITERAL(nL,   metric::nanoliter)
+DEFINE_UNIT_LITERAL(uL,   metric::microliter)
+DEFINE_UNIT_LITERAL(mL,   metric::milliliter)
+DEFINE_UNIT_LITERAL(cL,   metric::centiliter)
+DEFINE_UNIT_LITERAL(dL,   metric::deciliter)
+SI_LARGER_PREFIX_LITERALS(L, liter)
+DEFINE_UNIT_LITERAL(mps,  metric::mps)
+DEFINE_UNIT_LITERAL(mps2, metric::mps2)
+DEFINE_UNIT_LITERAL(kph,  metric::kph)
+
+SI_ALL_PREFIX_LITERALS(Hz, hertz)
+SI_ALL_PREFIX_LITERALS(N, newton)
+SI_ALL_PREFIX_LITERALS(Pa, pascal)
+SI_ALL_PREFIX_LITERALS(J, joule)
+SI_ALL_PREFIX_LITERALS(W, watt)
+SI_ALL_PREFIX_LITERALS(C, coloumb)
+SI_ALL_PREFIX_LITERALS(V, volt)
+SI_ALL_PREFIX_LITERALS(F, farad)
+SI_ALL_PREFIX_LITERALS(ohm, ohm)
+SI_ALL_PREFIX_LITERALS(S, siemens)
+SI_ALL_PREFIX_LITERALS(Wb, weber)
+SI_ALL_PREFIX_LITERALS(T, tesla)
+SI_ALL_PREFIX_LITERALS(H, henry)
+SI_ALL_PREFIX_LITERALS(Bq, becquerel)
+SI_ALL_PREFIX_LITERALS(Gy, gray)
+SI_ALL_PREFIX_LITERALS(Sv, sievert)
+SI_ALL_PREFIX_LITERALS(kat, katal)
+
+} /* namespace literals */
 } /* namespace units */
 
 #endif
@@ -3,139 +3,395 @@
 
 #include "unit.h"
 
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
 namespace units {
 
-template<typename U, typename N> unit_number<N, U> make_unit_number(const N& n) {
+template<typename U, typename N> constexpr unit_number<N, U> make_unit_number(const N& n) noexcept {
     return unit_number<N, U>{n};
 }
 
+// Customization point describing a representation type of unit_number.
+// Specialize it for types modeling the arithmetic operations, such as SIMD
+// vectors, fixed point or interval numbers. Their operations must not throw.
+// scalar_type is the element type used to build conversion factors.
+template<typename N>
+struct number_traits {
+    static constexpr bool is_number = std::is_arithmetic<N>::value;
+    static constexpr bool is_floating_point = std::is_floating_point<N>::value;
+    using scalar_type = N;
+};
+
+namespace number_detail {
+
+    template<typename T>
+    struct is_unit_number : public std::false_type {};
+    template<typename N, typename U>
+    struct is_unit_number<unit_number<N, U>> : public std::true_type {};
+
+    template<typename T>
+    struct is_unit_multiple : public std::false_type {};
+    template<typename R, typename U>
+    struct is_unit_multiple<unit_multiple<R, U>> : public std::true_type {};
+
+    // A unit_number stores its value in multiples of a scale: either a plain
+    // unit (scale 1) or a unit_multiple.
+
+    template<typename U>
+    struct scale_impl {
+        using ratio = std::ratio<1>;
+        using base = U;
+    };
+    template<typename R, typename U>
+    struct scale_impl<unit_multiple<R, U>> {
+        using ratio = R;
+        using base = U;
+    };
+
+    template<typename U>
+    using scale_of = typename scale_impl<U>::ratio;
+
+    template<typename U>
+    using base_unit_of = typename scale_impl<U>::base;
+
+    template<typename U>
+    struct is_scaled_unit {
+        static constexpr bool value = unit_detail::is_unit<base_unit_of<U>>::value;
+    };
+
+    // unit_multiple<R, U> for a non-trivial R, U otherwise.
+    template<typename R, typename U>
+    using scaled_unit = meta::static_if<R::num == 1 and R::den == 1,
+        U, unit_multiple<std::ratio<R::num, R::den>, U>>;
+
+    template<typename U>
+    using normalize = scaled_unit<scale_of<U>, base_unit_of<U>>;
+
+    template<typename U, typename V>
+    struct same_base {
+        static constexpr bool value =
+            std::is_same<base_unit_of<U>, base_unit_of<V>>::value;
+    };
+
+    // Largest scale both R1 and R2 are integral multiples of.
+    template<typename R1, typename R2>
+    using common_ratio = std::ratio<
+        std::gcd(R1::num, R2::num),
+        std::lcm(R1::den, R2::den)
+    >;
+
+    template<typename U, typename V>
+    using common_unit = scaled_unit<
+        common_ratio<scale_of<U>, scale_of<V>>, base_unit_of<U>>;
+
+    // Converting between scales is exact when the target is floating point or
+    // the source scale is an integral multiple of the target scale.
+    template<typename N, typename U, typename M, typename V>
+    struct is_lossless_conversion {
+        static constexpr bool value = same_base<U, V>::value and
+            (number_traits<N>::is_floating_point or
+             (std::ratio_divide<scale_of<V>, scale_of<U>>::den == 1 and
+              not number_traits<M>::is_floating_point));
+    };
+
+    // Conversion factors are resolved at compile time. Floating point targets
+    // multiply by R computed once in long double and rounded to the working
+    // type. Integer targets multiply, divide or, for general ratios, multiply
+    // and divide in 128 bits so that the result is exact whenever it fits.
+    // A result that does not fit is a compile error in constant expressions
+    // and fails an assert otherwise.
+
+    // Built-in numbers are converted in their common type, other
+    // representations in the target type.
+    template<typename To, typename From, bool = std::is_arithmetic<To>::value
+                                             and std::is_arithmetic<From>::value>
+    struct conversion_type_impl {
+        using type = To;
+    };
+    template<typename To, typename From>
+    struct conversion_type_impl<To, From, true> {
+        using type = meta::static_if<
+            std::is_floating_point<To>::value or std::is_floating_point<From>::value,
+            std::common_type_t<To, From>,
+            std::common_type_t<To, From, meta::static_if<
+                std::is_signed<To>::value or std::is_signed<From>::value,
+                intmax_t, uintmax_t>>
+        >;
+    };
+
+    template<typename To, typename From>
+    using conversion_type = typename conversion_type_impl<To, From>::type;
+
+    template<typename C, typename T>
+    constexpr C number_constant(const T& x) noexcept {
+        return static_cast<C>(static_cast<typename number_traits<C>::scalar_type>(x));
+    }
+
+#ifdef __SIZEOF_INT128__
+    // __extension__ keeps -Wpedantic quiet about the non-standard types.
+    __extension__ typedef __int128 int128;
+    __extension__ typedef unsigned __int128 uint128;
+
+    template<typename C>
+    using wide_type = meta::static_if<std::is_signed<C>::value, int128, uint128>;
+#endif
+
+    // The factor of an integer target must fit the target, otherwise every
+    // number but zero overflows.
+    template<typename R, typename To, bool = std::is_integral<To>::value>
+    struct factor_fits : public std::true_type {};
+    template<typename R, typename To>
+    struct factor_fits<R, To, true> {
+        static constexpr bool value = static_cast<uintmax_t>(R::num / R::den) <=
+            static_cast<uintmax_t>(std::numeric_limits<To>::max());
+    };
+
+    // Not constexpr, so that a conversion overflowing its target does not
+    // compile in a constant expression.
+    inline void conversion_overflow() noexcept {
+        assert(false and "Conversion result overflows the number type.");
+    }
+
+    // x, an integer of the conversion type or its 128-bit widening, as a To.
+    template<typename To, typename T>
+    constexpr To narrow(const T& x) noexcept {
+        constexpr bool is_signed = static_cast<T>(-1) < static_cast<T>(0);
+        if constexpr (is_signed) {
+            constexpr T low = std::is_signed<To>::value ? static_cast<T>(std::numeric_limits<To>::min()) : 0;
+            if (x < low) {
+                conversion_overflow();
+            }
+        }
+        if (x > static_cast<T>(std::numeric_limits<To>::max())) {
+            conversion_overflow();
+        }
+        return static_cast<To>(x);
+    }
+
+    template<typename R, typename To, typename From>
+    struct conversion {
+        using C = conversion_type<To, From>;
+
+        static constexpr long double factor =
+            static_cast<long double>(R::num) / static_cast<long double>(R::den);
+
+        static constexpr bool is_identity = R::num == 1 and R::den == 1;
+        static constexpr bool is_floating = number_traits<C>::is_floating_point;
+        static constexpr bool is_integral = std::is_integral<To>::value and std::is_arithmetic<C>::value;
+
+        static_assert(is_floating or factor_fits<R, To>::value,
+            "Conversion factor overflows the number type.");
+
+        static constexpr To apply(const From& x) noexcept {
+            if constexpr (is_identity) {
+                if constexpr (is_integral) {
+                    return narrow<To>(static_cast<C>(x));
+                } else {
+                    return static_cast<To>(x);
+                }
+            } else if constexpr (is_floating) {
+                return static_cast<To>(static_cast<C>(x) * number_constant<C>(factor));
+            } else if constexpr (not is_integral) {
+                if constexpr (R::den == 1) {
+                    return static_cast<To>(static_cast<C>(x) * number_constant<C>(R::num));
+                } else if constexpr (R::num == 1) {
+                    return static_cast<To>(static_cast<C>(x) / number_constant<C>(R::den));
+                } else {
+                    return static_cast<To>(static_cast<C>(x) * number_constant<C>(R::num)
+                                           / number_constant<C>(R::den));
+                }
+            } else if constexpr (R::den == 1) {
+                return narrow<To>(static_cast<C>(x) * static_cast<C>(R::num));
+            } else if constexpr (R::num == 1) {
+                return narrow<To>(static_cast<C>(x) / static_cast<C>(R::den));
+            } else {
+#ifdef __SIZEOF_INT128__
+                using W = wide_type<C>;
+                return narrow<To>(static_cast<W>(static_cast<C>(x)) * static_cast<W>(R::num)
+                                  / static_cast<W>(R::den));
+#else
+                constexpr C num = static_cast<C>(R::num);
+                constexpr C den = static_cast<C>(R::den);
+                const C y = static_cast<C>(x);
+                return narrow<To>(y / den * num + y % den * num / den);
+#endif
+            }
+        }
+    };
+
+    template<typename R, typename To, typename From>
+    constexpr To rescale(const From& x) noexcept {
+        return conversion<R, To, From>::apply(x);
+    }
+
+} /* namespace number_detail */
+
+template<typename To, typename N, typename U>
+constexpr To unit_cast(const unit_number<N, U>& x) noexcept;
+
 template<typename N, typename U>
 class unit_number {
-    static_assert(std::is_arithmetic<N>::value,
-        "N-parameter must be arithmetic.");
-    static_assert(unit_detail::is_unit<U>::value,
-        "U-parameter must be a unit type.");
+    static_assert(number_traits<N>::is_number,
+        "N-parameter must be arithmetic or have number_traits.");
+    static_assert(number_detail::is_scaled_unit<U>::value,
+        "U-parameter must be a unit or unit_multiple type.");
+    static_assert(std::is_same<U, number_detail::normalize<U>>::value,
+        "U-parameter must not be a unit_multiple with a ratio of one or an unreduced ratio.");
+
+    template<typename V>
+    using ratio_to = std::ratio_divide<number_detail::scale_of<V>,
+                                       number_detail::scale_of<U>>;
 
 public:
     using number_type = N;
     using unit_type = U;
+    using ratio_type = number_detail::scale_of<U>;
+    using base_unit_type = number_detail::base_unit_of<U>;
 
-    explicit unit_number(const N& x) : value_(x) {}
+    // Leaves the number uninitialized like N, so that arrays and buffers of
+    // quantities cost no zero-fill. unit_number<N, U>{} is zero. Define
+    // UNITS_VALUE_INITIALIZE_NUMBERS to value-initialize the number instead,
+    // at the price of a non-trivial default constructor.
+    unit_number() noexcept = default;
 
-    template<typename M>
-    explicit unit_number(const M& x) : value_(x) {}
+    constexpr explicit unit_number(const N& x) noexcept : value_(x) {}
+
+    template<typename M, typename = std::enable_if_t<
+        not number_detail::is_unit_number<M>::value>>
+    constexpr explicit unit_number(const M& x) noexcept : value_(x) {}
 
     template<typename M>
-    unit_number(const unit_number<M, U>& x) : value_(x.value_) {}
+    constexpr unit_number(const unit_number<M, U>& x) noexcept : value_(x.value_) {}
+
+    template<typename M, typename V, typename = std::enable_if_t<
+        not std::is_same<U, V>::value and
+        number_detail::is_lossless_conversion<N, U, M, V>::value>>
+    constexpr unit_number(const unit_number<M, V>& x) noexcept
+        : value_(number_detail::rescale<ratio_to<V>, N>(x.value_)) {}
 
     template<typename M>
-    unit_number<N, U>& operator= (const unit_number<M, U>& x) {
+    constexpr unit_number<N, U>& operator= (const unit_number<M, U>& x) noexcept {
         value_ = x.value_;
         return *this;
     }
 
-    template<typename M>
-    explicit operator M() const {
-        return M{value_};
+    template<typename M, typename = std::enable_if_t<number_traits<M>::is_number>>
+    constexpr explicit operator M() const noexcept {
+        return static_cast<M>(value_);
     }
 
-    unit_number<N, U> operator+ () const {
+    constexpr unit_number<N, U> operator+ () const noexcept {
         return *this;
     }
 
-    unit_number<N, U> operator- () const {
+    constexpr unit_number<N, U> operator- () const noexcept {
         return make_unit_number<U>(-value_);
     }
 
     template<typename M>
-    auto operator+ (const unit_number<M, U>& number) const {
+    constexpr auto operator+ (const unit_number<M, U>& number) const noexcept {
         return make_unit_number<U>(value_ + number.value_);
     }
 
-    template<typename M>
-    unit_number<N, U>& operator+= (const unit_number<M, U>& number) {
-        value_ += number.value_;
+    template<typename M, typename V, typename = std::enable_if_t<
+        not std::is_same<U, V>::value and number_detail::same_base<U, V>::value>>
+    constexpr auto operator+ (const unit_number<M, V>& number) const noexcept {
+        using W = number_detail::common_unit<U, V>;
+        return unit_cast<unit_number<N, W>>(*this) + unit_cast<unit_number<M, W>>(number);
+    }
+
+    template<typename M, typename V, typename = std::enable_if_t<
+        number_detail::is_lossless_conversion<N, U, M, V>::value>>
+    constexpr unit_number<N, U>& operator+= (const unit_number<M, V>& number) noexcept {
+        value_ += number_detail::rescale<ratio_to<V>, N>(number.value_);
         return *this;
     }
 
     template<typename M>
-    auto operator- (const unit_number<M, U>& number) const {
+    constexpr auto operator- (const unit_number<M, U>& number) const noexcept {
         return make_unit_number<U>(value_ - number.value_);
     }
 
-    template<typename M>
-    unit_number<N, U>& operator-= (const unit_number<M, U>& number) {
-        value_ -= number.value_;
+    template<typename M, typename V, typename = std::enable_if_t<
+        not std::is_same<U, V>::value and number_detail::same_base<U, V>::value>>
+    constexpr auto operator- (const unit_number<M, V>& number) const noexcept {
+        using W = number_detail::common_unit<U, V>;
+        return unit_cast<unit_number<N, W>>(*this) - unit_cast<unit_number<M, W>>(number);
+    }
+
+    template<typename M, typename V, typename = std::enable_if_t<
+        number_detail::is_lossless_conversion<N, U, M, V>::value>>
+    constexpr unit_number<N, U>& operator-= (const unit_number<M, V>& number) noexcept {
+        value_ -= number_detail::rescale<ratio_to<V>, N>(number.value_);
         return *this;
     }
 
     template<typename M, typename V>
-    auto operator* (const unit_number<M, V>& number) const {
-        using W = decltype(U{} * V{});
+    constexpr auto operator* (const unit_number<M, V>& number) const noexcept {
+        using W = number_detail::normalize<decltype(U{} * V{})>;
         return make_unit_number<W>(value_ * number.value_);
     }
 
     template<typename R, typename V>
-    auto operator* (const unit_multiple<R, V>& u) const {
-        using W = decltype(U{} * V{});
-        return make_unit_number<W>(value_ * (N{R::num} / N{R::den}));
+    constexpr auto operator* (const unit_multiple<R, V>& u) const noexcept {
+        using W = number_detail::normalize<decltype(U{} * u)>;
+        return make_unit_number<W>(value_);
     }
 
     template<typename... D>
-    auto operator* (const unit<D...>& u) const {
-        using W = decltype(U{} * unit<D...>{});
+    constexpr auto operator* (const unit<D...>& u) const noexcept {
+        using W = number_detail::normalize<decltype(U{} * u)>;
         return make_unit_number<W>(value_);
     }
 
     template<typename M, typename V>
-    auto operator/ (const unit_number<M, V>& number) const {
-        using W = decltype(U{} / V{});
+    constexpr auto operator/ (const unit_number<M, V>& number) const noexcept {
+        using W = number_detail::normalize<decltype(U{} / V{})>;
         return make_unit_number<W>(value_ / number.value_);
     }
 
     template<typename R, typename V>
-    auto operator/ (const unit_multiple<R, V>& u) const {
-        using W = decltype(U{} / V{});
-        return make_unit_number<W>(value_ * (N{R::den} / N{R::num}));
+    constexpr auto operator/ (const unit_multiple<R, V>& u) const noexcept {
+        using W = number_detail::normalize<decltype(U{} / u)>;
+        return make_unit_number<W>(value_);
     }
 
     template<typename... D>
-    auto operator/ (const unit<D...>& u) const {
-        using W = decltype(U{} / unit<D...>{});
+    constexpr auto operator/ (const unit<D...>& u) const noexcept {
+        using W = number_detail::normalize<decltype(U{} / u)>;
         return make_unit_number<W>(value_);
     }
 
-    template<typename M>
-    bool operator< (const unit_number<M, U>& number) const {
-        return value_ < number.value_;
-    }
-
-    template<typename M>
-    bool operator<= (const unit_number<M, U>& number) const {
-        return value_ <= number.value_;
-    }
-
-    template<typename M>
-    bool operator> (const unit_number<M, U>& number) const {
-        return value_ > number.value_;
+#define UNITS_NUMBER_COMPARISON(op)                                            \
+    template<typename M>                                                       \
+    constexpr auto operator op (const unit_number<M, U>& number) const noexcept {\
+        return value_ op number.value_;                                        \
+    }                                                                          \
+                                                                               \
+    template<typename M, typename V, typename = std::enable_if_t<              \
+        not std::is_same<U, V>::value and number_detail::same_base<U, V>::value>>\
+    constexpr auto operator op (const unit_number<M, V>& number) const noexcept {\
+        using W = number_detail::common_unit<U, V>;                            \
+        return unit_cast<unit_number<N, W>>(*this) op                          \
+               unit_cast<unit_number<M, W>>(number);                           \
     }
 
-    template<typename M>
-    bool operator>= (const unit_number<M, U>& number) const {
-        return value_ >= number.value_;
-    }
+    UNITS_NUMBER_COMPARISON(<)
+    UNITS_NUMBER_COMPARISON(<=)
+    UNITS_NUMBER_COMPARISON(>)
+    UNITS_NUMBER_COMPARISON(>=)
+    UNITS_NUMBER_COMPARISON(==)
+    UNITS_NUMBER_COMPARISON(!=)
 
-    template<typename M>
-    bool operator== (const unit_number<M, U>& number) const {
-        return value_ == number.value_;
-    }
+#undef UNITS_NUMBER_COMPARISON
 
-    template<typename M>
-    bool operator!= (const unit_number<M, U>& number) const {
-        return value_ == number.value_;
-    }
-
-    N value() const {
+    // The value in multiples of ratio_type.
+    constexpr N value() const noexcept {
         return value_;
     }
 
@@ -143,21 +399,76 @@ public:
     friend class unit_number;
 
 private:
+#ifdef UNITS_VALUE_INITIALIZE_NUMBERS
+    N value_{};
+#else
     N value_;
-
+#endif
 };
 
-template<typename N, typename... D>
-auto operator* (const N& n, const unit<D...>& u) {
+namespace number_detail {
+
+    // Whether unit_number<N, U> is laid out and copied exactly like N, so
+    // that arrays of it can be copied with memcpy, mapped from files and
+    // bit cast. Holds for all arithmetic N.
+    template<typename N, typename U>
+    struct has_number_layout {
+        using type = unit_number<N, U>;
+        static constexpr bool value =
+            std::is_trivially_copyable<type>::value == std::is_trivially_copyable<N>::value and
+            std::is_standard_layout<type>::value == std::is_standard_layout<N>::value and
+#ifndef UNITS_VALUE_INITIALIZE_NUMBERS
+            std::is_trivially_default_constructible<type>::value ==
+                std::is_trivially_default_constructible<N>::value and
+#endif
+            sizeof(type) == sizeof(N) and alignof(type) == alignof(N);
+    };
+
+    static_assert(has_number_layout<double, Scalar>::value and
+                  has_number_layout<float, unit_multiple<std::kilo, Scalar>>::value and
+                  has_number_layout<int, Scalar>::value and
+                  has_number_layout<long double, Scalar>::value,
+        "unit_number must be laid out like its number.");
+
+} /* namespace number_detail */
+
+// Converts x to the scale and number type of To, truncating integers if the
+// scales are not integral multiples of each other.
+template<typename To, typename N, typename U>
+constexpr To unit_cast(const unit_number<N, U>& x) noexcept {
+    static_assert(number_detail::is_unit_number<To>::value,
+        "Target of unit_cast must be a unit_number type.");
+    using V = typename To::unit_type;
+    static_assert(number_detail::same_base<U, V>::value,
+        "unit_cast cannot change the dimensions of a unit_number.");
+    using R = std::ratio_divide<number_detail::scale_of<U>, number_detail::scale_of<V>>;
+    using M = typename To::number_type;
+    return To{number_detail::rescale<R, M>(x.value())};
+}
+
+template<typename N, typename... D,
+         typename = std::enable_if_t<number_traits<N>::is_number>>
+constexpr auto operator* (const N& n, const unit<D...>& u) noexcept {
     return make_unit_number<unit<D...>>(n);
 }
 
-template<typename N, typename R, typename U>
-auto operator* (const N& n, const unit_multiple<R, U>&) {
-    return make_unit_number<U>(n * (N{R::num} / N{R::den}));
+template<typename N, typename R, typename U,
+         typename = std::enable_if_t<number_traits<N>::is_number>>
+constexpr auto operator* (const N& n, const unit_multiple<R, U>&) noexcept {
+    return make_unit_number<number_detail::scaled_unit<R, U>>(n);
 }
 
 
+// Defines the user-defined literal _suffix for the unit x, e.g. 9.8_mps2.
+// Literals always produce double quantities.
+#define DEFINE_UNIT_LITERAL(suffix, x)                                         \
+    constexpr auto operator""_##suffix(long double v) noexcept {               \
+        return static_cast<double>(v) * x;                                     \
+    }                                                                          \
+    constexpr auto operator""_##suffix(unsigned long long v) noexcept {        \
+        return static_cast<double>(v) * x;                                     \
+    }
+
 template<typename N, typename U>
 std::ostream& operator<< (std::ostream& os, const unit_number<N, U>& num) {
     return os << num.value() << " " << U{};
@@ -205,7 +516,7 @@ namespace number_detail {
 
     template<typename N, typename U>
     struct unit_type_impl<unit_number<N, U>> {
-        using type = U;
+        using type = base_unit_of<U>;
     };
 
 } /* namespace number_detail */
@@ -215,4 +526,15 @@ using unit_type = typename ::units::number_detail::unit_type_impl<typename std::
 
 } /* namespace units */
 
+// Hash of the number mixed with the fingerprint of the unit, so that equal
+// numbers in different units hash differently.
+template<typename N, typename U>
+struct std::hash<units::unit_number<N, U>> {
+    std::size_t operator() (const units::unit_number<N, U>& x) const noexcept {
+        const std::size_t h = std::hash<N>{}(x.value());
+        constexpr auto fingerprint = static_cast<std::size_t>(U::fingerprint);
+        return h ^ (fingerprint + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+    }
+};
+
 #endif
@@ -0,0 +1,308 @@
+#ifndef UNITS_PARSE_H
+#define UNITS_PARSE_H
+
+#include "dynamic.h"
+#include "number.h"
+#include "registry.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace units {
+
+enum class parse_errc {
+    ok,
+    invalid_number,
+    invalid_syntax,
+    unknown_unit,
+    dimension_mismatch,
+    out_of_range
+};
+
+// Like std::from_chars_result: ptr is one past the parsed text on success and
+// points where parsing stopped otherwise.
+struct parse_result {
+    const char* ptr;
+    parse_errc ec;
+};
+
+namespace parse_detail {
+
+    // A unit known at run time: the factor to its base unit and the packed
+    // exponents of its dimensions, as in dynamic_quantity.
+    struct runtime_unit {
+        double factor = 1.0;
+        std::uint64_t exponents = 0;
+    };
+
+    constexpr double power(double x, int exponent) noexcept {
+        if (exponent == 1) {
+            return x;
+        }
+        if (exponent == -1) {
+            return 1.0 / x;
+        }
+        double result = 1.0;
+        for (int i = 0; i < (exponent < 0 ? -exponent : exponent); ++i) {
+            result *= x;
+        }
+        return exponent < 0 ? 1.0 / result : result;
+    }
+
+    // a *= b^exponent. Fails if an exponent leaves the representable range.
+    constexpr bool multiply(runtime_unit& a, const runtime_unit& b, int exponent) noexcept {
+        a.factor *= power(b.factor, exponent);
+        if (exponent == 1) {
+            const std::uint64_t e = dynamic_detail::add(a.exponents, b.exponents);
+            const bool fits = not dynamic_detail::add_overflows(a.exponents, b.exponents, e);
+            a.exponents = e;
+            return fits;
+        }
+        if (exponent == -1) {
+            const std::uint64_t e = dynamic_detail::subtract(a.exponents, b.exponents);
+            const bool fits = not dynamic_detail::subtract_overflows(a.exponents, b.exponents, e);
+            a.exponents = e;
+            return fits;
+        }
+        bool fits = exponent >= -128 and exponent <= 127;
+        std::uint64_t e = 0;
+        for (std::size_t i = 0; i < dynamic_detail::dimension_count; ++i) {
+            const int x = static_cast<std::int8_t>(static_cast<std::uint8_t>(a.exponents >> (8 * i))) +
+                          static_cast<std::int8_t>(static_cast<std::uint8_t>(b.exponents >> (8 * i))) * exponent;
+            fits = fits and x >= -128 and x <= 127;
+            e |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(x)) << (8 * i);
+        }
+        a.exponents = e;
+        return fits;
+    }
+
+    template<typename U>
+    constexpr runtime_unit runtime_unit_of = {
+        static_cast<double>(number_detail::scale_of<std::remove_cv_t<U>>::num) /
+        static_cast<double>(number_detail::scale_of<std::remove_cv_t<U>>::den),
+        dynamic_detail::packed_of<std::remove_cv_t<U>>
+    };
+
+    // Resolves a unit name through the registry.
+    constexpr bool lookup(std::string_view name, runtime_unit& result) noexcept {
+        const registered_unit* u = find_unit(name);
+        if (not u) {
+            return false;
+        }
+        result = runtime_unit{u->scale, u->exponents};
+        return true;
+    }
+
+    // Recursive descent over
+    //   expression := factor { ('*' | '/') factor }
+    //   factor     := primary [ '^' ['-'] digits ]
+    //   primary    := name | '1' | '(' expression ')'
+    // with optional blanks between tokens.
+    class parser {
+    public:
+        parser(const char* first, const char* last) noexcept : p_(first), last_(last) {}
+
+        const char* position() const noexcept { return p_; }
+
+        void skip_blanks() noexcept {
+            while (p_ != last_ and (*p_ == ' ' or *p_ == '\t')) {
+                ++p_;
+            }
+        }
+
+        // Whether a unit expression starts at the current position.
+        bool at_unit() const noexcept {
+            return p_ != last_ and (is_name_start(*p_) or *p_ == '(' or
+                (*p_ == '1' and p_ + 1 != last_ and p_[1] == '/'));
+        }
+
+        parse_errc expression(runtime_unit& result, int depth = 0) noexcept {
+            parse_errc ec = factor(result, depth);
+            while (ec == parse_errc::ok) {
+                const char* mark = p_;
+                skip_blanks();
+                if (p_ == last_ or (*p_ != '*' and *p_ != '/')) {
+                    p_ = mark;
+                    break;
+                }
+                const int sign = *p_ == '*' ? 1 : -1;
+                ++p_;
+                skip_blanks();
+                runtime_unit next;
+                ec = factor(next, depth);
+                if (ec == parse_errc::ok and not multiply(result, next, sign)) {
+                    ec = parse_errc::out_of_range;
+                }
+            }
+            return ec;
+        }
+
+    private:
+        static constexpr int max_depth = 8;
+
+        static bool is_name_start(char c) noexcept {
+            return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or c == '_';
+        }
+
+        static bool is_name_char(char c) noexcept {
+            return is_name_start(c) or (c >= '0' and c <= '9') or c == ':';
+        }
+
+        parse_errc factor(runtime_unit& result, int depth) noexcept {
+            parse_errc ec = primary(result, depth);
+            if (ec != parse_errc::ok or p_ == last_ or *p_ != '^') {
+                return ec;
+            }
+            ++p_;
+            int exponent = 0;
+            const auto [ptr, error] = std::from_chars(p_, last_, exponent);
+            if (error != std::errc{}) {
+                return parse_errc::invalid_syntax;
+            }
+            p_ = ptr;
+            const runtime_unit base = result;
+            result = runtime_unit{};
+            return multiply(result, base, exponent) ? parse_errc::ok : parse_errc::out_of_range;
+        }
+
+        parse_errc primary(runtime_unit& result, int depth) noexcept {
+            if (p_ == last_) {
+                return parse_errc::invalid_syntax;
+            }
+            if (*p_ == '(') {
+                if (depth == max_depth) {
+                    return parse_errc::invalid_syntax;
+                }
+                ++p_;
+                skip_blanks();
+                const parse_errc ec = expression(result, depth + 1);
+                if (ec != parse_errc::ok) {
+                    return ec;
+                }
+                skip_blanks();
+                if (p_ == last_ or *p_ != ')') {
+                    return parse_errc::invalid_syntax;
+                }
+                ++p_;
+                return parse_errc::ok;
+            }
+            if (*p_ == '1') {
+                ++p_;
+                result = runtime_unit{};
+                return parse_errc::ok;
+            }
+            if (not is_name_start(*p_)) {
+                return parse_errc::invalid_syntax;
+            }
+            const char* first = p_;
+            while (p_ != last_ and is_name_char(*p_)) {
+                ++p_;
+            }
+            if (not lookup(std::string_view(first, static_cast<std::size_t>(p_ - first)), result)) {
+                p_ = first;
+                return parse_errc::unknown_unit;
+            }
+            return parse_errc::ok;
+        }
+
+        const char* p_;
+        const char* last_;
+    };
+
+    // Reads a number and an optional unit expression after it.
+    template<typename N>
+    parse_result read(const char* first, const char* last, N& number, runtime_unit& unit) noexcept {
+        parser p{first, last};
+        p.skip_blanks();
+        const auto [ptr, error] = std::from_chars(p.position(), last, number);
+        if (error == std::errc::invalid_argument) {
+            return {first, parse_errc::invalid_number};
+        }
+        if (error == std::errc::result_out_of_range) {
+            return {ptr, parse_errc::out_of_range};
+        }
+
+        p = parser{ptr, last};
+        p.skip_blanks();
+        if (not p.at_unit()) {
+            return {ptr, parse_errc::ok};
+        }
+        const parse_errc ec = p.expression(unit);
+        return {p.position(), ec};
+    }
+
+} /* namespace parse_detail */
+
+// Parses a number followed by an optional unit expression, such as
+// "9.8 m/s^2", "12 km" or "3 us::gallon", into value. The unit must have the
+// dimensions of U and is converted to its scale. Integer numbers are rounded
+// to the nearest value after conversion. Nothing is allocated.
+template<typename N, typename U>
+parse_result parse(const char* first, const char* last, unit_number<N, U>& value) noexcept {
+    static_assert(std::is_arithmetic<N>::value, "Only arithmetic numbers can be parsed.");
+
+    // Integers are read as long double, so that fractions and exponents
+    // such as "1.5 km" or "3e10 m" are part of the number, which is only
+    // rounded and range checked after the conversion.
+    using read_t = std::conditional_t<std::is_floating_point<N>::value, N, long double>;
+    read_t number{};
+    parse_detail::runtime_unit parsed;
+    const parse_result result = parse_detail::read(first, last, number, parsed);
+    if (result.ec != parse_errc::ok) {
+        return result;
+    }
+
+    constexpr parse_detail::runtime_unit target = parse_detail::runtime_unit_of<U>;
+    if (parsed.exponents != target.exponents) {
+        return {result.ptr, parse_errc::dimension_mismatch};
+    }
+
+    const double factor = parsed.factor / target.factor;
+    if constexpr (std::is_floating_point<N>::value) {
+        value = unit_number<N, U>{factor == 1.0 ? number : static_cast<N>(number * factor)};
+    } else {
+        const long double x = std::round(number * static_cast<long double>(factor));
+        if (not (x >= static_cast<long double>(std::numeric_limits<N>::min()) and
+                 x <= static_cast<long double>(std::numeric_limits<N>::max()))) {
+            return {result.ptr, parse_errc::out_of_range};
+        }
+        value = unit_number<N, U>{static_cast<N>(x)};
+    }
+    return result;
+}
+
+// Parses a number followed by an optional unit expression of any
+// dimensions into value, in the base unit of the dimensions.
+template<typename N>
+parse_result parse(const char* first, const char* last, dynamic_quantity<N>& value) noexcept {
+    static_assert(std::is_floating_point<N>::value, "Only floating point dynamic quantities can be parsed.");
+
+    N number{};
+    parse_detail::runtime_unit parsed;
+    const parse_result result = parse_detail::read(first, last, number, parsed);
+    if (result.ec != parse_errc::ok) {
+        return result;
+    }
+    value = dynamic_quantity<N>{static_cast<N>(number * parsed.factor), parsed.exponents};
+    return result;
+}
+
+template<typename N>
+parse_result parse(std::string_view text, dynamic_quantity<N>& value) noexcept {
+    return parse(text.data(), text.data() + text.size(), value);
+}
+
+template<typename N, typename U>
+parse_result parse(std::string_view text, unit_number<N, U>& value) noexcept {
+    return parse(text.data(), text.data() + text.size(), value);
+}
+
+} /* namespace units */
+
+#endif
@@ -0,0 +1,586 @@
+#ifndef UNITS_REGISTRY_H
+#define UNITS_REGISTRY_H
+
+#include "dynamic.h"
+#include "general.h"
+#include "imperial.h"
+#include "metric.h"
+#include "number.h"
+#include "us.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace units {
+
+// A catalog unit known by name at run time: the packed exponents of its
+// dimensions (see dynamic_quantity), its exact scale to the base unit of the
+// dimensions as num/den, or 0/0 where that does not fit in intmax_t, and
+// the same scale and its inverse as doubles, each rounded once.
+struct registered_unit {
+    std::string_view name;
+    std::uint64_t exponents;
+    std::intmax_t num;
+    std::intmax_t den;
+    double scale;
+    double inverse;
+};
+
+namespace registry_detail {
+
+    // Symbols of kind short_prefix are also registered with every SI prefix
+    // symbol such as "k" or "da", long_prefix ones with every SI prefix name
+    // such as "kilo".
+    enum class symbol_kind : unsigned char {
+        plain,
+        short_prefix,
+        long_prefix
+    };
+
+    struct symbol {
+        std::string_view name;
+        std::uint64_t exponents;
+        std::intmax_t num;
+        std::intmax_t den;
+        symbol_kind kind;
+    };
+
+    struct prefix {
+        std::string_view name;
+        std::intmax_t num;
+        std::intmax_t den;
+    };
+
+#define UNITS_REGISTRY_PREFIX(name, ratio) prefix{name, ratio::num, ratio::den}
+
+    inline constexpr prefix short_prefixes[] = {
+        UNITS_REGISTRY_PREFIX("a", std::atto), UNITS_REGISTRY_PREFIX("f", std::femto),
+        UNITS_REGISTRY_PREFIX("p", std::pico), UNITS_REGISTRY_PREFIX("n", std::nano),
+        UNITS_REGISTRY_PREFIX("u", std::micro), UNITS_REGISTRY_PREFIX("m", std::milli),
+        UNITS_REGISTRY_PREFIX("c", std::centi), UNITS_REGISTRY_PREFIX("d", std::deci),
+        UNITS_REGISTRY_PREFIX("da", std::deca), UNITS_REGISTRY_PREFIX("h", std::hecto),
+        UNITS_REGISTRY_PREFIX("k", std::kilo), UNITS_REGISTRY_PREFIX("M", std::mega),
+        UNITS_REGISTRY_PREFIX("G", std::giga), UNITS_REGISTRY_PREFIX("T", std::tera),
+        UNITS_REGISTRY_PREFIX("P", std::peta), UNITS_REGISTRY_PREFIX("E", std::exa)
+    };
+
+    inline constexpr prefix long_prefixes[] = {
+        UNITS_REGISTRY_PREFIX("atto", std::atto), UNITS_REGISTRY_PREFIX("femto", std::femto),
+        UNITS_REGISTRY_PREFIX("pico", std::pico), UNITS_REGISTRY_PREFIX("nano", std::nano),
+        UNITS_REGISTRY_PREFIX("micro", std::micro), UNITS_REGISTRY_PREFIX("milli", std::milli),
+        UNITS_REGISTRY_PREFIX("centi", std::centi), UNITS_REGISTRY_PREFIX("deci", std::deci),
+        UNITS_REGISTRY_PREFIX("deca", std::deca), UNITS_REGISTRY_PREFIX("hecto", std::hecto),
+        UNITS_REGISTRY_PREFIX("kilo", std::kilo), UNITS_REGISTRY_PREFIX("mega", std::mega),
+        UNITS_REGISTRY_PREFIX("giga", std::giga), UNITS_REGISTRY_PREFIX("tera", std::tera),
+        UNITS_REGISTRY_PREFIX("peta", std::peta), UNITS_REGISTRY_PREFIX("exa", std::exa)
+    };
+
+    constexpr std::size_t prefix_count = std::size(short_prefixes);
+    static_assert(std::size(long_prefixes) == prefix_count, "Every prefix needs a symbol and a name.");
+
+#undef UNITS_REGISTRY_PREFIX
+
+    template<typename T>
+    struct symbol_of {
+        using unit_t = std::remove_cv_t<T>;
+        using scale = number_detail::scale_of<unit_t>;
+        static constexpr std::uint64_t exponents = dynamic_detail::packed_of<unit_t>;
+    };
+
+#define UNITS_REGISTRY_SYMBOL(name, x, kind)                                   \
+    symbol{name, symbol_of<decltype(x)>::exponents,                            \
+           symbol_of<decltype(x)>::scale::num,                                 \
+           symbol_of<decltype(x)>::scale::den, symbol_kind::kind},
+
+#define UNITS_REGISTRY_METRIC(symbol, name)                                    \
+    UNITS_REGISTRY_SYMBOL(#symbol, metric::name, short_prefix)                 \
+    UNITS_REGISTRY_SYMBOL(#name, metric::name, long_prefix)
+
+    // The literal suffixes and catalog names of general.h and metric.h, and
+    // the qualified catalog names of us.h and imperial.h.
+    inline constexpr symbol symbols[] = {
+        UNITS_REGISTRY_SYMBOL("s", second, short_prefix)
+        UNITS_REGISTRY_SYMBOL("second", second, long_prefix)
+        UNITS_REGISTRY_SYMBOL("min", minute, plain)
+        UNITS_REGISTRY_SYMBOL("minute", minute, plain)
+        UNITS_REGISTRY_SYMBOL("h", hour, plain)
+        UNITS_REGISTRY_SYMBOL("hour", hour, plain)
+        UNITS_REGISTRY_SYMBOL("d", day, plain)
+        UNITS_REGISTRY_SYMBOL("day", day, plain)
+        UNITS_REGISTRY_SYMBOL("week", week, plain)
+        UNITS_REGISTRY_SYMBOL("fortnight", fortnight, plain)
+        UNITS_REGISTRY_SYMBOL("year", year, plain)
+
+        UNITS_REGISTRY_METRIC(m, meter)
+        UNITS_REGISTRY_METRIC(g, gram)
+        UNITS_REGISTRY_METRIC(L, liter)
+        UNITS_REGISTRY_METRIC(Hz, hertz)
+        UNITS_REGISTRY_METRIC(N, newton)
+        UNITS_REGISTRY_METRIC(Pa, pascal)
+        UNITS_REGISTRY_METRIC(J, joule)
+        UNITS_REGISTRY_METRIC(W, watt)
+        UNITS_REGISTRY_METRIC(C, coloumb)
+        UNITS_REGISTRY_METRIC(V, volt)
+        UNITS_REGISTRY_METRIC(F, farad)
+        UNITS_REGISTRY_SYMBOL("ohm", metric::ohm, short_prefix)
+        UNITS_REGISTRY_METRIC(S, siemens)
+        UNITS_REGISTRY_METRIC(Wb, weber)
+        UNITS_REGISTRY_METRIC(T, tesla)
+        UNITS_REGISTRY_METRIC(H, henry)
+        UNITS_REGISTRY_METRIC(Bq, becquerel)
+        UNITS_REGISTRY_METRIC(Gy, gray)
+        UNITS_REGISTRY_METRIC(Sv, sievert)
+        UNITS_REGISTRY_METRIC(kat, katal)
+
+        UNITS_REGISTRY_SYMBOL("t", metric::tonne, plain)
+        UNITS_REGISTRY_SYMBOL("tonne", metric::tonne, plain)
+        UNITS_REGISTRY_SYMBOL("K", metric::kelvin, plain)
+        UNITS_REGISTRY_SYMBOL("kelvin", metric::kelvin, plain)
+        UNITS_REGISTRY_SYMBOL("A", metric::ampere, plain)
+        UNITS_REGISTRY_SYMBOL("ampere", metric::ampere, plain)
+        UNITS_REGISTRY_SYMBOL("cd", metric::candela, plain)
+        UNITS_REGISTRY_SYMBOL("candela", metric::candela, plain)
+        UNITS_REGISTRY_SYMBOL("mol", metric::mole, plain)
+        UNITS_REGISTRY_SYMBOL("mole", metric::mole, plain)
+        UNITS_REGISTRY_SYMBOL("rad", metric::radian, plain)
+        UNITS_REGISTRY_SYMBOL("radian", metric::radian, plain)
+        UNITS_REGISTRY_SYMBOL("deg", metric::degree, plain)
+        UNITS_REGISTRY_SYMBOL("degree", metric::degree, plain)
+        UNITS_REGISTRY_SYMBOL("m2", metric::square_meter, plain)
+        UNITS_REGISTRY_SYMBOL("square_meter", metric::square_meter, plain)
+        UNITS_REGISTRY_SYMBOL("m3", metric::cubic_meter, plain)
+        UNITS_REGISTRY_SYMBOL("cubic_meter", metric::cubic_meter, plain)
+        UNITS_REGISTRY_SYMBOL("mps", metric::mps, plain)
+        UNITS_REGISTRY_SYMBOL("mps2", metric::mps2, plain)
+        UNITS_REGISTRY_SYMBOL("kph", metric::kph, plain)
+
+        UNITS_REGISTRY_SYMBOL("us::inch", us::inch, plain)
+        UNITS_REGISTRY_SYMBOL("us::foot", us::foot, plain)
+        UNITS_REGISTRY_SYMBOL("us::yard", us::yard, plain)
+        UNITS_REGISTRY_SYMBOL("us::mile", us::mile, plain)
+        UNITS_REGISTRY_SYMBOL("us::pica", us::pica, plain)
+        UNITS_REGISTRY_SYMBOL("us::point", us::point, plain)
+        UNITS_REGISTRY_SYMBOL("us::link", us::link, plain)
+        UNITS_REGISTRY_SYMBOL("us::rod", us::rod, plain)
+        UNITS_REGISTRY_SYMBOL("us::chain", us::chain, plain)
+        UNITS_REGISTRY_SYMBOL("us::furlong", us::furlong, plain)
+        UNITS_REGISTRY_SYMBOL("us::survey", us::survey, plain)
+        UNITS_REGISTRY_SYMBOL("us::league", us::league, plain)
+        UNITS_REGISTRY_SYMBOL("us::fathom", us::fathom, plain)
+        UNITS_REGISTRY_SYMBOL("us::cable", us::cable, plain)
+        UNITS_REGISTRY_SYMBOL("us::nautical_mile", us::nautical_mile, plain)
+        UNITS_REGISTRY_SYMBOL("us::sq_foot", us::sq_foot, plain)
+        UNITS_REGISTRY_SYMBOL("us::sq_chain", us::sq_chain, plain)
+        UNITS_REGISTRY_SYMBOL("us::acre", us::acre, plain)
+        UNITS_REGISTRY_SYMBOL("us::section", us::section, plain)
+        UNITS_REGISTRY_SYMBOL("us::cubic_inch", us::cubic_inch, plain)
+        UNITS_REGISTRY_SYMBOL("us::cubic_foot", us::cubic_foot, plain)
+        UNITS_REGISTRY_SYMBOL("us::cubic_yard", us::cubic_yard, plain)
+        UNITS_REGISTRY_SYMBOL("us::acre_foot", us::acre_foot, plain)
+        UNITS_REGISTRY_SYMBOL("us::pint", us::pint, plain)
+        UNITS_REGISTRY_SYMBOL("us::quart", us::quart, plain)
+        UNITS_REGISTRY_SYMBOL("us::gallon", us::gallon, plain)
+        UNITS_REGISTRY_SYMBOL("us::barrel", us::barrel, plain)
+        UNITS_REGISTRY_SYMBOL("us::hogshead", us::hogshead, plain)
+        UNITS_REGISTRY_SYMBOL("us::cup", us::cup, plain)
+        UNITS_REGISTRY_SYMBOL("us::gill", us::gill, plain)
+        UNITS_REGISTRY_SYMBOL("us::fluid_ounce", us::fluid_ounce, plain)
+        UNITS_REGISTRY_SYMBOL("us::tablespoon", us::tablespoon, plain)
+        UNITS_REGISTRY_SYMBOL("us::teaspoon", us::teaspoon, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::pint", us::dry::pint, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::quart", us::dry::quart, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::gallon", us::dry::gallon, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::peck", us::dry::peck, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::bushel", us::dry::bushel, plain)
+        UNITS_REGISTRY_SYMBOL("us::dry::barrel", us::dry::barrel, plain)
+        UNITS_REGISTRY_SYMBOL("us::pound", us::pound, plain)
+        UNITS_REGISTRY_SYMBOL("us::hundredweight", us::hundredweight, plain)
+        UNITS_REGISTRY_SYMBOL("us::long_hundredweight", us::long_hundredweight, plain)
+        UNITS_REGISTRY_SYMBOL("us::ton", us::ton, plain)
+        UNITS_REGISTRY_SYMBOL("us::ounce", us::ounce, plain)
+        UNITS_REGISTRY_SYMBOL("us::dram", us::dram, plain)
+        UNITS_REGISTRY_SYMBOL("us::grain", us::grain, plain)
+        UNITS_REGISTRY_SYMBOL("us::board_foot", us::board_foot, plain)
+        UNITS_REGISTRY_SYMBOL("us::calorie", us::calorie, plain)
+        UNITS_REGISTRY_SYMBOL("us::food_calorie", us::food_calorie, plain)
+
+        UNITS_REGISTRY_SYMBOL("imperial::yard", imperial::yard, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::foot", imperial::foot, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::inch", imperial::inch, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::chain", imperial::chain, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::furlong", imperial::furlong, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::mile", imperial::mile, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::league", imperial::league, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::pound", imperial::pound, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::stone", imperial::stone, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::ton", imperial::ton, plain)
+        UNITS_REGISTRY_SYMBOL("imperial::acre", imperial::acre, plain)
+    };
+
+#undef UNITS_REGISTRY_METRIC
+#undef UNITS_REGISTRY_SYMBOL
+
+    constexpr const prefix* prefixes_of(symbol_kind kind) noexcept {
+        return kind == symbol_kind::short_prefix ? short_prefixes : long_prefixes;
+    }
+
+    // Registered names of s: its own and one per prefix.
+    constexpr std::size_t names_of(const symbol& s) noexcept {
+        return s.kind == symbol_kind::plain ? 1 : 1 + prefix_count;
+    }
+
+    constexpr std::size_t count_units() noexcept {
+        std::size_t result = 0;
+        for (const symbol& s : symbols) {
+            result += names_of(s);
+        }
+        return result;
+    }
+
+    constexpr std::size_t count_chars() noexcept {
+        std::size_t result = 0;
+        for (const symbol& s : symbols) {
+            result += s.name.size();
+            if (s.kind != symbol_kind::plain) {
+                for (std::size_t i = 0; i < prefix_count; ++i) {
+                    result += prefixes_of(s.kind)[i].name.size() + s.name.size();
+                }
+            }
+        }
+        return result;
+    }
+
+    constexpr std::size_t unit_count = count_units();
+    constexpr std::size_t char_count = count_chars();
+
+    constexpr std::intmax_t gcd(std::intmax_t a, std::intmax_t b) noexcept {
+        while (b != 0) {
+            const std::intmax_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    // a * b, or false where it does not fit.
+    constexpr bool multiply(std::intmax_t a, std::intmax_t b, std::intmax_t& result) noexcept {
+        if (a != 0 and b > INTMAX_MAX / a) {
+            return false;
+        }
+        result = a * b;
+        return true;
+    }
+
+#ifdef __SIZEOF_INT128__
+    using number_detail::uint128;
+
+    // n / d rounded once to the nearest double. Long division produces the
+    // leading 64 bits of the quotient, and a set low bit records that the
+    // remainder is not zero, so that converting them rounds correctly.
+    constexpr double quotient(uint128 n, uint128 d) noexcept {
+        constexpr uint128 top = uint128{1} << 63;
+        uint128 q = n / d;
+        uint128 r = n % d;
+        int exponent = 0;
+        bool sticky = false;
+        while (q >= (top << 1)) {
+            sticky = sticky or (q & 1) != 0;
+            q >>= 1;
+            ++exponent;
+        }
+        while (q < top) {
+            r <<= 1;
+            q <<= 1;
+            if (r >= d) {
+                r -= d;
+                q |= 1;
+            }
+            --exponent;
+        }
+        sticky = sticky or r != 0;
+        double x = static_cast<double>(static_cast<std::uint64_t>(q) | (sticky ? 1 : 0));
+        for (; exponent > 0; --exponent) {
+            x *= 2.0;
+        }
+        for (; exponent < 0; ++exponent) {
+            x *= 0.5;
+        }
+        return x;
+    }
+#else
+    constexpr double quotient(long double n, long double d) noexcept {
+        return static_cast<double>(n / d);
+    }
+#endif
+
+    // The exact scale num / den as a double, rounded once.
+    constexpr double exact_scale(std::intmax_t num, std::intmax_t den) noexcept {
+        return quotient(static_cast<std::uintmax_t>(num), static_cast<std::uintmax_t>(den));
+    }
+
+    // The exact ratio of the scales of from and to as a double, rounded
+    // once. Scales that do not fit in intmax_t fall back to the doubles.
+    constexpr double factor_of(const registered_unit& from, const registered_unit& to) noexcept {
+        if (from.den == 0 or to.den == 0) {
+            return from.scale * to.inverse;
+        }
+        const std::intmax_t a = gcd(from.num, to.num);
+        const std::intmax_t b = gcd(from.den, to.den);
+#ifdef __SIZEOF_INT128__
+        using wide = uint128;
+#else
+        using wide = long double;
+#endif
+        return quotient(static_cast<wide>(from.num / a) * static_cast<wide>(to.den / b),
+                        static_cast<wide>(from.den / b) * static_cast<wide>(to.num / a));
+    }
+
+    // All registered units, with their names stored back to back in chars.
+    struct unit_table {
+        char chars[char_count] = {};
+        std::size_t offsets[unit_count] = {};
+        registered_unit units[unit_count] = {};
+    };
+
+    constexpr unit_table make_table() noexcept {
+        unit_table table;
+        std::size_t chars = 0;
+        std::size_t n = 0;
+        const auto add = [&](const prefix* p, const symbol& s) {
+            registered_unit& u = table.units[n];
+            table.offsets[n++] = chars;
+            u.exponents = s.exponents;
+            u.num = s.num;
+            u.den = s.den;
+            u.scale = static_cast<double>(s.num) / static_cast<double>(s.den);
+            if (p) {
+                for (char c : p->name) {
+                    table.chars[chars++] = c;
+                }
+                const std::intmax_t a = gcd(p->num, s.den);
+                const std::intmax_t b = gcd(s.num, p->den);
+                if (not multiply(p->num / a, s.num / b, u.num) or
+                    not multiply(p->den / b, s.den / a, u.den)) {
+                    u.num = 0;
+                    u.den = 0;
+                }
+                u.scale *= static_cast<double>(p->num) / static_cast<double>(p->den);
+            }
+            for (char c : s.name) {
+                table.chars[chars++] = c;
+            }
+            if (u.den != 0) {
+                u.scale = exact_scale(u.num, u.den);
+                u.inverse = exact_scale(u.den, u.num);
+            } else {
+                u.inverse = 1.0 / u.scale;
+            }
+        };
+        for (const symbol& s : symbols) {
+            add(nullptr, s);
+            if (s.kind != symbol_kind::plain) {
+                for (std::size_t i = 0; i < prefix_count; ++i) {
+                    add(&prefixes_of(s.kind)[i], s);
+                }
+            }
+        }
+        return table;
+    }
+
+    // The names are views of the characters of the table itself, so they
+    // are only set once the table has its final address.
+    constexpr unit_table name_units(unit_table table, const char* chars) noexcept {
+        for (std::size_t i = 0; i < unit_count; ++i) {
+            const std::size_t last = i + 1 < unit_count ? table.offsets[i + 1] : char_count;
+            table.units[i].name = std::string_view(chars + table.offsets[i], last - table.offsets[i]);
+        }
+        return table;
+    }
+
+    inline constexpr unit_table unnamed_table = make_table();
+    inline constexpr unit_table table = name_units(unnamed_table, unnamed_table.chars);
+
+    constexpr std::size_t ceil_power_of_two(std::size_t x) noexcept {
+        std::size_t result = 1;
+        while (result < x) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    // Hash and displace perfect hash over the names of Keys entries, built at
+    // compile time. A name hashes to a bucket, and the displacement stored
+    // for the bucket moves all of its names to distinct free slots, so a
+    // lookup is two table reads and one string compare.
+    template<std::size_t Keys>
+    class perfect_hash {
+        static_assert(Keys < 0xffff, "Too many keys for a perfect_hash.");
+
+        static constexpr std::size_t buckets = Keys / 2 + 1;
+        static constexpr std::size_t slots = ceil_power_of_two(2 * Keys);
+        static constexpr std::size_t max_bucket_size = 16;
+        static constexpr std::uint32_t max_displacement = 1u << 16;
+
+    public:
+        template<typename Entry>
+        constexpr explicit perfect_hash(const Entry (&entries)[Keys]) noexcept {
+            std::uint64_t hashes[Keys] = {};
+            std::size_t sizes[buckets] = {};
+            for (std::size_t i = 0; i < Keys; ++i) {
+                hashes[i] = hash(entries[i].name);
+                ++sizes[bucket(hashes[i])];
+            }
+            for (std::size_t i = 0; i < slots; ++i) {
+                keys_[i] = Keys;
+            }
+
+            // Place the largest buckets first, while most slots are free.
+            bool used[slots] = {};
+            for (std::size_t size = max_bucket_size; size > 0; --size) {
+                for (std::size_t b = 0; b < buckets; ++b) {
+                    if (sizes[b] == size and not place(b, hashes, used)) {
+                        return;
+                    }
+                }
+            }
+            for (std::size_t b = 0; b < buckets; ++b) {
+                if (sizes[b] > max_bucket_size) {
+                    return;
+                }
+            }
+            valid_ = true;
+        }
+
+        // False if two keys are equal or could not be separated.
+        constexpr bool valid() const noexcept { return valid_; }
+
+        // Index of the only entry that may be named name, or Keys.
+        constexpr std::size_t find(std::string_view name) const noexcept {
+            const std::uint64_t h = hash(name);
+            return keys_[slot(h, displacements_[bucket(h)])];
+        }
+
+        static constexpr std::uint64_t hash(std::string_view name) noexcept {
+            return string_detail::fnv1a(name.data(), name.size());
+        }
+
+    private:
+        static constexpr std::size_t bucket(std::uint64_t h) noexcept {
+            return static_cast<std::size_t>(h >> 32) % buckets;
+        }
+
+        static constexpr std::size_t slot(std::uint64_t h, std::uint32_t d) noexcept {
+            std::uint64_t x = h + d * 0x9e3779b97f4a7c15ull;
+            x ^= x >> 32;
+            x *= 0xd6e8feb86659fd93ull;
+            x ^= x >> 32;
+            return static_cast<std::size_t>(x) & (slots - 1);
+        }
+
+        constexpr bool place(std::size_t b, const std::uint64_t (&hashes)[Keys], bool (&used)[slots]) noexcept {
+            std::size_t members[max_bucket_size] = {};
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < Keys; ++i) {
+                if (bucket(hashes[i]) == b) {
+                    members[count++] = i;
+                }
+            }
+            for (std::uint32_t d = 0; d < max_displacement; ++d) {
+                std::size_t taken[max_bucket_size] = {};
+                bool fits = true;
+                for (std::size_t j = 0; j < count and fits; ++j) {
+                    taken[j] = slot(hashes[members[j]], d);
+                    fits = not used[taken[j]];
+                    for (std::size_t k = 0; k < j and fits; ++k) {
+                        fits = taken[k] != taken[j];
+                    }
+                }
+                if (fits) {
+                    for (std::size_t j = 0; j < count; ++j) {
+                        used[taken[j]] = true;
+                        keys_[taken[j]] = static_cast<std::uint16_t>(members[j]);
+                    }
+                    displacements_[b] = d;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::uint32_t displacements_[buckets] = {};
+        std::uint16_t keys_[slots] = {};
+        bool valid_ = false;
+    };
+
+    inline constexpr perfect_hash<unit_count> unit_hash{table.units};
+    static_assert(unit_hash.valid(), "Registered unit names must be distinct.");
+
+    // Names are short, so an inline loop beats a call to memcmp.
+    constexpr bool equal(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} /* namespace registry_detail */
+
+// The registered unit called name, or null. Names are the literal suffixes
+// and catalog names of general.h and metric.h, with every SI prefix where
+// the catalog defines them ("km", "kilometer", "ms", "GHz"), and the
+// qualified names of us.h and imperial.h ("us::foot", "imperial::stone").
+// Metric names may also be qualified with "metric::". A lookup hashes the
+// name once and compares it once.
+constexpr const registered_unit* find_unit(std::string_view name) noexcept {
+    constexpr std::string_view metric_namespace = "metric::";
+    if (name.size() > metric_namespace.size() and name[0] == 'm' and
+        registry_detail::equal(name.substr(0, metric_namespace.size()), metric_namespace)) {
+        name.remove_prefix(metric_namespace.size());
+    }
+    const std::size_t i = registry_detail::unit_hash.find(name);
+    const registered_unit* u = &registry_detail::table.units[i < registry_detail::unit_count ? i : 0];
+    return i < registry_detail::unit_count and registry_detail::equal(u->name, name) ? u : nullptr;
+}
+
+// All registered units, in registration order.
+constexpr const auto& registered_units() noexcept {
+    return registry_detail::table.units;
+}
+
+// Factor taking numbers in from to numbers in to, or nothing if their
+// dimensions differ. The factor is the exact ratio of the two scales,
+// rounded once, so "us::foot" to "us::inch" gives exactly 12.
+constexpr std::optional<double> factor(const registered_unit& from, const registered_unit& to) noexcept {
+    if (from.exponents != to.exponents) {
+        return std::nullopt;
+    }
+    return registry_detail::factor_of(from, to);
+}
+
+constexpr std::optional<double> factor(std::string_view from, std::string_view to) noexcept {
+    const registered_unit* a = find_unit(from);
+    const registered_unit* b = find_unit(to);
+    if (not a or not b) {
+        return std::nullopt;
+    }
+    return factor(*a, *b);
+}
+
+// x in the unit u as a dynamic_quantity in the base unit of its dimensions.
+template<typename N>
+constexpr dynamic_quantity<N> make_dynamic_quantity(const N& x, const registered_unit& u) noexcept {
+    return dynamic_quantity<N>{static_cast<N>(x * u.scale), u.exponents};
+}
+
+} /* namespace units */
+
+#endif
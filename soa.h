@@ -0,0 +1,239 @@
+#ifndef UNITS_SOA_H
+#define UNITS_SOA_H
+
+#include "meta.h"
+#include "number.h"
+#include "vector.h"
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+namespace units {
+
+// Declares the field name##_field holding values of the unit_number type
+// quantity. Rows of a record container with this field get a member function
+// name() that reads or writes the field like a struct member.
+#define DEFINE_SOA_FIELD(name, quantity)                                       \
+    struct name##_field {                                                      \
+        using value_type = quantity;                                           \
+        template<typename Row>                                                 \
+        struct accessor {                                                      \
+            constexpr auto name() const noexcept {                             \
+                return static_cast<const Row&>(*this)                          \
+                    .template get<name##_field>();                             \
+            }                                                                  \
+        };                                                                     \
+    };
+
+namespace soa_detail {
+
+    template<typename Field>
+    using number_of = typename Field::value_type::number_type;
+
+    template<typename Field>
+    using unit_of = typename Field::value_type::unit_type;
+
+    template<typename Field>
+    using column_of = unit_vector<number_of<Field>, unit_of<Field>>;
+
+    template<bool Const, typename Field>
+    using pointer_of = meta::static_if<Const, const number_of<Field>*, number_of<Field>*>;
+
+    // One pointer into every column, all at the same row.
+    template<bool Const, typename... Fields>
+    using pointers = std::tuple<pointer_of<Const, Fields>...>;
+
+    template<typename Field, typename... Fields>
+    constexpr std::size_t field_index() noexcept {
+        constexpr std::size_t i = meta::index_of<Field, meta::type_list<Fields...>>::value;
+        static_assert(i < sizeof...(Fields), "The field is not part of this record.");
+        return i;
+    }
+
+    template<typename Field, typename... Fields>
+    constexpr std::size_t count_of = (std::size_t{0} + ... + std::is_same<Field, Fields>::value);
+
+    template<typename... Pointers>
+    constexpr std::tuple<Pointers...> advance(const std::tuple<Pointers...>& p, std::size_t i) noexcept {
+        return std::apply([i](Pointers... x) {
+            return std::tuple<Pointers...>{(x + i)...};
+        }, p);
+    }
+
+} /* namespace soa_detail */
+
+// Proxy for one row of a record container. Each field reads as a unit_number
+// and, unless Const, can be assigned through a unit_reference.
+template<bool Const, typename... Fields>
+class soa_row : public Fields::template accessor<soa_row<Const, Fields...>>... {
+public:
+    constexpr explicit soa_row(const soa_detail::pointers<Const, Fields...>& p) noexcept : p_(p) {}
+
+    template<typename Field>
+    constexpr auto get() const noexcept {
+        using pointer = soa_detail::pointer_of<Const, Field>;
+        using iterator = vector_detail::unit_iterator<std::remove_pointer_t<pointer>,
+                                                      soa_detail::unit_of<Field>>;
+        return iterator::dereference(std::get<soa_detail::field_index<Field, Fields...>()>(p_));
+    }
+
+    constexpr std::tuple<typename Fields::value_type...> values() const noexcept {
+        return {typename Fields::value_type{get<Fields>()}...};
+    }
+
+    constexpr operator soa_row<true, Fields...>() const noexcept {
+        return soa_row<true, Fields...>{p_};
+    }
+
+private:
+    soa_detail::pointers<Const, Fields...> p_;
+};
+
+namespace soa_detail {
+
+    // Rows are soa_row proxies returned by value rather than references, so
+    // the iterator is an input iterator: algorithms dispatching on a
+    // stronger category could keep references to rows that are gone.
+    template<bool Const, typename... Fields>
+    class row_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::tuple<typename Fields::value_type...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = soa_row<Const, Fields...>;
+        using pointer = void;
+
+        constexpr row_iterator(const pointers<Const, Fields...>& p, std::size_t i) noexcept
+            : p_(p), i_(i) {}
+
+        constexpr reference operator* () const noexcept { return reference{advance(p_, i_)}; }
+
+        constexpr row_iterator& operator++ () noexcept { ++i_; return *this; }
+        constexpr row_iterator operator++ (int) noexcept { return row_iterator{p_, i_++}; }
+
+        constexpr bool operator== (const row_iterator& x) const noexcept { return i_ == x.i_; }
+        constexpr bool operator!= (const row_iterator& x) const noexcept { return i_ != x.i_; }
+
+    private:
+        pointers<Const, Fields...> p_;
+        std::size_t i_;
+    };
+
+} /* namespace soa_detail */
+
+// Non-owning view of some of the columns of a record container. Kernels take
+// a view of just the fields they touch, either row by row or as whole
+// columns for the elementwise unit_span operations.
+template<bool Const, typename... Fields>
+class soa_view {
+public:
+    using row = soa_row<Const, Fields...>;
+    using iterator = soa_detail::row_iterator<Const, Fields...>;
+    using size_type = std::size_t;
+
+    constexpr soa_view(const soa_detail::pointers<Const, Fields...>& p, std::size_t size) noexcept
+        : p_(p), size_(size) {}
+
+    constexpr operator soa_view<true, Fields...>() const noexcept {
+        return soa_view<true, Fields...>{p_, size_};
+    }
+
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr row operator[] (std::size_t i) const noexcept {
+        return row{soa_detail::advance(p_, i)};
+    }
+
+    constexpr iterator begin() const noexcept { return iterator{p_, 0}; }
+    constexpr iterator end() const noexcept { return iterator{p_, size_}; }
+
+    template<typename Field>
+    constexpr auto column() const noexcept {
+        using number = std::remove_pointer_t<soa_detail::pointer_of<Const, Field>>;
+        return unit_span<number, soa_detail::unit_of<Field>>{
+            std::get<soa_detail::field_index<Field, Fields...>()>(p_), size_};
+    }
+
+    template<typename... Subset>
+    constexpr soa_view<Const, Subset...> view() const noexcept {
+        return {soa_detail::pointers<Const, Subset...>{
+            std::get<soa_detail::field_index<Subset, Fields...>()>(p_)...}, size_};
+    }
+
+private:
+    soa_detail::pointers<Const, Fields...> p_;
+    std::size_t size_;
+};
+
+template<typename... Fields>
+using soa_const_view = soa_view<true, Fields...>;
+
+// Structure of arrays record container: every field is stored in its own
+// aligned unit_vector column, and all columns have the same size.
+template<typename... Fields>
+class soa_vector {
+    static_assert(sizeof...(Fields) > 0, "A record needs at least one field.");
+    static_assert((true and ... and (soa_detail::count_of<Fields, Fields...> == 1)),
+        "Every field of a record must be distinct.");
+
+public:
+    using value_type = std::tuple<typename Fields::value_type...>;
+    using row = soa_row<false, Fields...>;
+    using const_row = soa_row<true, Fields...>;
+    using iterator = soa_detail::row_iterator<false, Fields...>;
+    using const_iterator = soa_detail::row_iterator<true, Fields...>;
+    using size_type = std::size_t;
+
+    soa_vector() = default;
+
+    explicit soa_vector(std::size_t size) : columns_(soa_detail::column_of<Fields>(size)...) {}
+
+    std::size_t size() const noexcept { return std::get<0>(columns_).size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    void reserve(std::size_t size) { (column<Fields>().reserve(size), ...); }
+    void resize(std::size_t size) { (column<Fields>().resize(size), ...); }
+    void clear() noexcept { (column<Fields>().clear(), ...); }
+
+    void push_back(const typename Fields::value_type&... values) {
+        (column<Fields>().push_back(values), ...);
+    }
+
+    template<typename Field>
+    soa_detail::column_of<Field>& column() noexcept {
+        return std::get<soa_detail::field_index<Field, Fields...>()>(columns_);
+    }
+
+    template<typename Field>
+    const soa_detail::column_of<Field>& column() const noexcept {
+        return std::get<soa_detail::field_index<Field, Fields...>()>(columns_);
+    }
+
+    template<typename... Subset>
+    soa_view<false, Subset...> view() noexcept {
+        return {soa_detail::pointers<false, Subset...>{column<Subset>().data()...}, size()};
+    }
+
+    template<typename... Subset>
+    soa_view<true, Subset...> view() const noexcept {
+        return {soa_detail::pointers<true, Subset...>{column<Subset>().data()...}, size()};
+    }
+
+    row operator[] (std::size_t i) noexcept { return view<Fields...>()[i]; }
+    const_row operator[] (std::size_t i) const noexcept { return view<Fields...>()[i]; }
+
+    iterator begin() noexcept { return view<Fields...>().begin(); }
+    iterator end() noexcept { return view<Fields...>().end(); }
+    const_iterator begin() const noexcept { return view<Fields...>().begin(); }
+    const_iterator end() const noexcept { return view<Fields...>().end(); }
+
+private:
+    std::tuple<soa_detail::column_of<Fields>...> columns_;
+};
+
+} /* namespace units */
+
+#endif
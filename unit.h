@@ -3,7 +3,10 @@
 
 #include "dimension.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <ratio>
+#include <string_view>
 
 namespace units {
 
@@ -33,8 +36,7 @@ namespace unit_detail {
         static_assert(is_dim_exp<Right>::value,
             "Right argument must be a dim exp.");
         static constexpr bool value =
-            compile_string_less<typename Left::dimension::name,
-                                typename Right::dimension::name>::value;
+            Left::dimension::id < Right::dimension::id;
     };
 
     template<typename Left, typename Right>
@@ -43,22 +45,22 @@ namespace unit_detail {
             "Left argument must be a dim exp.");
         static_assert(is_dim_exp<Right>::value,
             "Right argument must be a dim exp.");
+        static_assert(Left::dimension::id != Right::dimension::id or
+            std::is_same<typename Left::dimension, typename Right::dimension>::value,
+            "Distinct dimensions must not share an identity.");
         static constexpr bool value =
-            compile_string_equal<typename Left::dimension::name,
-                                 typename Right::dimension::name>::value;
+            Left::dimension::id == Right::dimension::id;
     };
 
-    template<typename Pair>
+    template<typename Left, typename Right>
     struct dim_exp_multiply_impl {
     private:
-        using Left = typename Pair::first_type;
-        using Right = typename Pair::second_type;
         static_assert(is_dim_exp<Left>::value,
             "Left argument must be a dim exp.");
         static_assert(is_dim_exp<Right>::value,
             "Right argument must be a dim exp.");
         using left_dim = typename Left::dimension;
-        using right_dim = typename Left::dimension;
+        using right_dim = typename Right::dimension;
         static_assert(std::is_same<left_dim, right_dim>::value,
             "Cannot multiply dim exps with mismatching dimensions.");
 
@@ -66,8 +68,8 @@ namespace unit_detail {
         using type = dim_exp<left_dim, Left::exponent + Right::exponent>;
     };
 
-    template<typename Pair>
-    using dim_exp_multiply = typename dim_exp_multiply_impl<Pair>::type;
+    template<typename Left, typename Right>
+    using dim_exp_multiply = typename dim_exp_multiply_impl<Left, Right>::type;
 
     template<typename Arg>
     struct is_negative_exp {
@@ -102,19 +104,8 @@ namespace unit_detail {
 
     template<typename Left, typename Right>
     struct unit_multiply_impl {
-    private:
-        using common = meta::filter<is_nonzero_exp,
-            meta::map<dim_exp_multiply,
-                meta::intersection<dim_exp_less, Left, Right>
-            >
-        >;
-        using left_uniq = meta::difference<dim_exp_less, Left, Right>;
-        using right_uniq = meta::difference<dim_exp_less, Right, Left>;
-        using combined = meta::sort<dim_exp_less,
-            meta::concat<left_uniq, common, right_uniq>
-        >;
-    public:
-        using type = meta::rebind<unit, combined>;
+        using type = meta::merge<dim_exp_less, dim_exp_multiply, is_nonzero_exp,
+            Left, Right>;
     };
 
     template<typename Left, typename Right>
@@ -142,37 +133,179 @@ namespace unit_detail {
         >;
     };
 
-    template<typename List> struct unit_printer {
-        static void print(std::ostream& os, bool close, bool invert) {}
-    };
+    // SI symbol of a base unit name, or the name itself.
+    constexpr std::string_view symbol_of(std::string_view base) {
+        constexpr std::string_view table[][2] = {
+            {"second", "s"}, {"meter", "m"}, {"kilogram", "kg"}, {"kelvin", "K"},
+            {"ampere", "A"}, {"candela", "cd"}, {"mole", "mol"}, {"radian", "rad"},
+        };
+        for (const auto& entry : table) {
+            if (entry[0] == base) {
+                return entry[1];
+            }
+        }
+        return base;
+    }
 
-    template<typename Head, typename... Tail>
-    struct unit_printer<meta::type_list<Head, Tail...>> {
-        static void print(std::ostream& os, bool close, bool invert) {
-            using base_name = typename Head::dimension::base_unit;
-            os << base_name{};
-            if (Head::exponent != (invert ? -1 : 1)) {
-                os << "^" << (invert ? -1 : 1) * Head::exponent;
+    // Appends text to out, or only counts it while out is null.
+    struct text_writer {
+        char* out = nullptr;
+        std::size_t size = 0;
+
+        constexpr void put(std::string_view s) {
+            for (char c : s) {
+                if (out) {
+                    out[size] = c;
+                }
+                ++size;
+            }
+        }
+
+        constexpr void put(intmax_t x) {
+            char digits[24] = {};
+            std::size_t n = 0;
+            const bool negative = x < 0;
+            do {
+                const int digit = static_cast<int>(x % 10);
+                digits[n++] = static_cast<char>('0' + (digit < 0 ? -digit : digit));
+                x /= 10;
+            } while (x != 0);
+            if (negative) {
+                digits[n++] = '-';
+            }
+            while (n != 0) {
+                put(std::string_view(&digits[--n], 1));
             }
-            os << "*";
-            unit_printer<meta::type_list<Tail...>>::print(os, close, invert);
         }
     };
 
-    template<typename Last>
-    struct unit_printer<meta::type_list<Last>> {
-        static void print(std::ostream& os, bool close, bool invert) {
-            using base_name = typename Last::dimension::base_unit;
-            os << base_name{};
-            if (Last::exponent != (invert ? -1 : 1)) {
-                os << "^" << (invert ? -1 : 1) * Last::exponent;
+    template<typename DimExp, bool Symbols>
+    constexpr void write_dim(text_writer& w, bool invert) {
+        using base_unit = typename DimExp::dimension::base_unit;
+        const std::string_view name{base_unit{}.c_str(), base_unit{}.size()};
+        w.put(Symbols ? symbol_of(name) : name);
+        const int exponent = invert ? -DimExp::exponent : DimExp::exponent;
+        if (exponent != 1) {
+            w.put("^");
+            w.put(exponent);
+        }
+    }
+
+    // The dimensions of List joined by '*', in parentheses if there is more
+    // than one and parens is set.
+    template<typename List, bool Symbols> struct dims_text;
+
+    template<typename... DimExps, bool Symbols>
+    struct dims_text<meta::type_list<DimExps...>, Symbols> {
+        static constexpr void write(text_writer& w, bool invert, bool parens) {
+            parens = parens and sizeof...(DimExps) > 1;
+            if (parens) {
+                w.put("(");
             }
-            if (close) {
-                os << ")";
+            bool first = true;
+            ((first ? void(first = false) : w.put("*"), write_dim<DimExps, Symbols>(w, invert)), ...);
+            if (parens) {
+                w.put(")");
             }
         }
     };
 
+    // Text of a unit with the dimensions List, such as "meter/second^2" or
+    // "(kilogram*meter^2)/second^2", or with Symbols "m/s^2".
+    template<typename List, bool Symbols>
+    constexpr void write_unit(text_writer& w) {
+        using num_dims = meta::filter<is_positive_exp, List>;
+        using denom_dims = meta::filter<is_negative_exp, List>;
+        // Compile time branches, so that dims_text is never written for an
+        // empty list.
+        if constexpr (List::size() == 0) {
+            w.put("[scalar]");
+            return;
+        }
+        if constexpr (num_dims::size() == 0) {
+            w.put("1");
+        } else {
+            dims_text<num_dims, Symbols>::write(w, false, denom_dims::size() != 0);
+        }
+        if constexpr (denom_dims::size() != 0) {
+            w.put("/");
+            dims_text<denom_dims, Symbols>::write(w, true, true);
+        }
+    }
+
+    // Text of a unit_multiple: the ratio, a blank and the text of the unit.
+    template<typename Ratio, typename List, bool Symbols>
+    constexpr void write_multiple(text_writer& w) {
+        w.put(Ratio::num);
+        w.put("/");
+        w.put(Ratio::den);
+        w.put(" ");
+        write_unit<List, Symbols>(w);
+    }
+
+    // One FNV-1a step per byte of word, least significant first.
+    constexpr std::uint64_t hash_word(std::uint64_t h, std::uint64_t word) {
+        for (int byte = 0; byte < 64; byte += 8) {
+            h ^= (word >> byte) & 0xff;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Hash of the identity and exponent of every dimension, in the sorted
+    // order of the unit. Dimension identities hash their names, so the
+    // result is the same in every build and with every compiler.
+    template<typename... DimExps>
+    constexpr std::uint64_t fingerprint(meta::type_list<DimExps...>) {
+        std::uint64_t h = 14695981039346656037ull;
+        ((h = hash_word(h, DimExps::dimension::id ^
+            static_cast<std::uint64_t>(static_cast<std::int64_t>(DimExps::exponent)) *
+            0x9e3779b97f4a7c15ull)), ...);
+        return h;
+    }
+
+    // A multiple also hashes its ratio, unless it is one.
+    template<typename Ratio, typename List>
+    constexpr std::uint64_t multiple_fingerprint() {
+        const std::uint64_t h = fingerprint(List{});
+        if (Ratio::num == Ratio::den) {
+            return h;
+        }
+        return hash_word(hash_word(h, static_cast<std::uint64_t>(Ratio::num)),
+                         static_cast<std::uint64_t>(Ratio::den));
+    }
+
+    template<std::size_t Size>
+    struct static_text {
+        char chars[Size + 1] = {};
+    };
+
+    // Null terminated text written by Write, built once at compile time.
+    template<void (*Write)(text_writer&)>
+    struct unit_text {
+    private:
+        static constexpr std::size_t count() {
+            text_writer w;
+            Write(w);
+            return w.size;
+        }
+
+        static constexpr std::size_t size = count();
+
+        static constexpr static_text<size> build() {
+            static_text<size> result;
+            text_writer w{result.chars};
+            Write(w);
+            return result;
+        }
+
+        static constexpr static_text<size> text = build();
+
+    public:
+        static constexpr const char* c_str = text.chars;
+        static constexpr std::string_view view{text.chars, size};
+    };
+
 } /* namespace unit_detail */
 
 template<typename... DimExps>
@@ -188,52 +321,66 @@ class unit {
         "Unit arguments must be unique.");
     using dims_list = meta::type_list<typename DimExps::dimension...>;
     using self = unit<DimExps...>;
+    using name_text = unit_detail::unit_text<&unit_detail::write_unit<list, false>>;
+    using symbol_text = unit_detail::unit_text<&unit_detail::write_unit<list, true>>;
 
 public:
     static constexpr size_t dims() { return sizeof...(DimExps); }
 
+    // Text of the unit as operator<< prints it, such as "meter/second^2",
+    // and the same with SI symbols, "m/s^2". Both are built at compile time
+    // and null terminated.
+    static constexpr std::string_view name = name_text::view;
+    static constexpr const char* c_name = name_text::c_str;
+    static constexpr std::string_view symbol = symbol_text::view;
+    static constexpr const char* c_symbol = symbol_text::c_str;
+
+    // Identity of the dimensions and exponents, stable across builds, so
+    // that units can be compared and looked up at run time as one integer.
+    static constexpr std::uint64_t fingerprint = unit_detail::fingerprint(list{});
+
     template<typename... OtherDims>
-    auto operator* (const unit<OtherDims...>& other) const {
+    constexpr auto operator* (const unit<OtherDims...>& other) const {
         using other_t = unit<OtherDims...>;
         return unit_detail::unit_multiply<self, other_t>{};
     }
 
     template<typename R, typename U>
-    auto operator* (const unit_multiple<R, U>&) const {
+    constexpr auto operator* (const unit_multiple<R, U>&) const {
         using result_t = unit_detail::unit_multiply<self, U>;
         return unit_multiple<R, result_t>{};
     }
 
     template<intmax_t N, intmax_t D>
-    auto operator* (const std::ratio<N, D>&) const {
-        return unit_multiple<std::ratio<N, D>, self>{};
+    constexpr auto operator* (const std::ratio<N, D>&) const {
+        return unit_multiple<typename std::ratio<N, D>::type, self>{};
     }
 
     template<typename... OtherDims>
-    auto operator/ (const unit<OtherDims...>& other) const {
+    constexpr auto operator/ (const unit<OtherDims...>& other) const {
         using inverse_t = typename decltype(other.invert())::self;
         return unit_detail::unit_multiply<self, inverse_t>{};
     }
 
     template<typename R, typename U>
-    auto operator/ (const unit_multiple<R, U>&) const {
+    constexpr auto operator/ (const unit_multiple<R, U>&) const {
         using result_ratio_t = std::ratio_divide<std::ratio<1>, R>;
         using result_unit_t = unit_detail::unit_multiply<self, decltype(U{}.invert())>;
         return unit_multiple<result_ratio_t, result_unit_t>{};
     }
 
     template<intmax_t N, intmax_t D>
-    auto operator/ (const std::ratio<N, D>&) const {
-        return unit_multiple<std::ratio<D, N>, self>{};
+    constexpr auto operator/ (const std::ratio<N, D>&) const {
+        return unit_multiple<typename std::ratio<D, N>::type, self>{};
     }
 
     template<int power>
-    auto exp() const {
+    constexpr auto exp() const {
         using result_t = typename unit_detail::unit_exp_impl<self, power>::type;
         return result_t{};
     }
 
-    auto invert() const {
+    constexpr auto invert() const {
         using result_t = typename unit_detail::unit_exp_impl<self, -1>::type;
         return result_t{};
     }
@@ -252,100 +399,90 @@ struct unit_multiple {
     using ratio_type = Ratio;
     using unit_type = Unit;
 
+private:
+    using list = meta::rebind<meta::type_list, Unit>;
+    using name_text = unit_detail::unit_text<&unit_detail::write_multiple<Ratio, list, false>>;
+    using symbol_text = unit_detail::unit_text<&unit_detail::write_multiple<Ratio, list, true>>;
+
+public:
+    // Text of the multiple as operator<< prints it, such as "1000/1 meter",
+    // and the same with SI symbols.
+    static constexpr std::string_view name = name_text::view;
+    static constexpr const char* c_name = name_text::c_str;
+    static constexpr std::string_view symbol = symbol_text::view;
+    static constexpr const char* c_symbol = symbol_text::c_str;
+
+    // Identity of the ratio and the dimensions, see unit::fingerprint.
+    static constexpr std::uint64_t fingerprint =
+        unit_detail::multiple_fingerprint<Ratio, list>();
+
     template<intmax_t N, intmax_t D>
-    auto operator* (const std::ratio<N, D>&) const {
+    constexpr auto operator* (const std::ratio<N, D>&) const {
         using ResultRatio = std::ratio_multiply<Ratio, std::ratio<N, D>>;
         return unit_multiple<ResultRatio, Unit>{};
     }
 
     template<typename R, typename U>
-    auto operator* (const unit_multiple<R, U>&) const {
+    constexpr auto operator* (const unit_multiple<R, U>&) const {
         using ResultRatio = std::ratio_multiply<Ratio, R>;
         using ResultUnit = decltype(Unit{} * U{});
         return unit_multiple<ResultRatio, ResultUnit>{};
     }
 
     template<typename... D>
-    auto operator* (const unit<D...>& u) const {
+    constexpr auto operator* (const unit<D...>& u) const {
         return u * (*this);
     }
 
     template<intmax_t N, intmax_t D>
-    auto operator/ (const std::ratio<N, D>&) const {
+    constexpr auto operator/ (const std::ratio<N, D>&) const {
         using ResultRatio = std::ratio_divide<Ratio, std::ratio<N, D>>;
         return unit_multiple<ResultRatio, Unit>{};
     }
 
     template<typename R, typename U>
-    auto operator/ (const unit_multiple<R, U>&) const {
+    constexpr auto operator/ (const unit_multiple<R, U>&) const {
         using ResultRatio = std::ratio_divide<Ratio, R>;
         using ResultUnit = decltype(Unit{} / U{});
         return unit_multiple<ResultRatio, ResultUnit>{};
     }
 
     template<typename... D>
-    auto operator/ (const unit<D...>& u) const {
+    constexpr auto operator/ (const unit<D...>& u) const {
         return u.invert() * (*this);
     }
 
 };
 
 template<intmax_t N, intmax_t D, typename... Dims>
-auto operator* (const std::ratio<N, D>& lhs, const unit<Dims...>& rhs) {
+constexpr auto operator* (const std::ratio<N, D>& lhs, const unit<Dims...>& rhs) {
     return rhs * lhs;
 }
 
 template<intmax_t N, intmax_t D, typename RRatio, typename Unit>
-auto operator* (const std::ratio<N, D>& lhs, const unit_multiple<RRatio, Unit>& rhs) {
+constexpr auto operator* (const std::ratio<N, D>& lhs, const unit_multiple<RRatio, Unit>& rhs) {
     return rhs * lhs;
 }
 
 template<intmax_t N, intmax_t D, typename... Dims>
-auto operator/ (const std::ratio<N, D>& lhs, const unit<Dims...>& rhs) {
-    return std::ratio<D, N>{} * lhs;
+constexpr auto operator/ (const std::ratio<N, D>& lhs, const unit<Dims...>& rhs) {
+    return lhs * rhs.invert();
 }
 
 template<intmax_t N, intmax_t D, typename RRatio, typename Unit>
-auto operator/ (const std::ratio<N, D>& lhs, const unit_multiple<RRatio, Unit>& rhs) {
-    return std::ratio<D, N>{} * lhs;
+constexpr auto operator/ (const std::ratio<N, D>& lhs, const unit_multiple<RRatio, Unit>& rhs) {
+    using ResultRatio = std::ratio_divide<std::ratio<N, D>, RRatio>;
+    return unit_multiple<ResultRatio, decltype(Unit{}.invert())>{};
 }
 
 template<typename... Dims>
 std::ostream& operator<< (std::ostream& os, const unit<Dims...>&) {
-    using list = meta::type_list<Dims...>;
-    // return os << "<" << sizeof...(Dims) << "> ";
-    if (sizeof...(Dims) == 0) {
-        return os << "[scalar]";
-    }
-
-    using num_dims = meta::filter<unit_detail::is_positive_exp, list>;
-    using denom_dims = meta::filter<unit_detail::is_negative_exp, list>;
-
-    if (num_dims::size() == 0) {
-        os << "1";
-    } else if (num_dims::size() == 1 or denom_dims::size() == 0) {
-        unit_detail::unit_printer<num_dims>::print(os, false, false);
-    } else if (denom_dims::size() != 0) {
-        os << "(";
-        unit_detail::unit_printer<num_dims>::print(os, true, false);
-    }
-
-    if (denom_dims::size() != 0) {
-        os << "/";
-    }
-
-    if (denom_dims::size() == 1) {
-        unit_detail::unit_printer<denom_dims>::print(os, false, true);
-    } else if(denom_dims::size() != 0) {
-        os << "(";
-        unit_detail::unit_printer<denom_dims>::print(os, true, true);
-    }
-    return os;
+    return os << unit<Dims...>::name;
 }
 
 template<typename R, typename U>
 std::ostream& operator<< (std::ostream& os, const unit_multiple<R, U>&) {
-    return os << R::num << "/" << R::den << " " << U{};
+    return os << unit_multiple<R, U>::name;
 }
 
 #define SETUP_UNIT_TYPES(name, x)                                              \
@@ -353,12 +490,13 @@ std::ostream& operator<< (std::ostream& os, const unit_multiple<R, U>&) {
     template<typename N> using name = unit_number<N, name##_u>;
 
 #define DEFINE_DIMENSION(name, base)                                           \
-    auto name##_symbol = COMPILE_STRING(#name);                                \
-    auto base##_symbol = COMPILE_STRING(#base);                                \
-    using name##_dim = dimension<decltype(name##_symbol), decltype(base##_symbol)>;\
+    inline constexpr auto name##_symbol = COMPILE_STRING(#name);               \
+    inline constexpr auto base##_symbol = COMPILE_STRING(#base);               \
+    using name##_dim = dimension<std::remove_const_t<decltype(name##_symbol)>, \
+                                 std::remove_const_t<decltype(base##_symbol)>>;\
     using name##_u = unit<unit_detail::dim_exp<name##_dim, 1>>;                \
     template<typename N> using name = unit_number<N, name##_u>;                \
-    name##_u base{};
+    inline constexpr name##_u base{};
 
 using Scalar = unit<>;
 
@@ -0,0 +1,437 @@
+#ifndef UNITS_UNIT_MATH_H
+#define UNITS_UNIT_MATH_H
+
+#include "meta.h"
+#include "metric.h"
+#include "number.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+namespace units {
+
+namespace math_detail {
+
+    // Largest r with r^Root <= x, or -1 if r^Root != x.
+    template<int Root>
+    constexpr std::intmax_t exact_root(std::intmax_t x) noexcept {
+        std::intmax_t lo = 0;
+        std::intmax_t hi = 1;
+        while (true) {
+            std::intmax_t p = 1;
+            for (int i = 0; i < Root and p <= x; ++i) {
+                p *= hi;
+            }
+            if (p >= x or hi > (std::intmax_t{1} << (62 / Root))) {
+                break;
+            }
+            hi *= 2;
+        }
+        while (lo < hi) {
+            const std::intmax_t mid = lo + (hi - lo + 1) / 2;
+            std::intmax_t p = 1;
+            for (int i = 0; i < Root and p <= x; ++i) {
+                p *= mid;
+            }
+            if (p <= x) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        std::intmax_t p = 1;
+        for (int i = 0; i < Root; ++i) {
+            p *= lo;
+        }
+        return p == x ? lo : -1;
+    }
+
+    template<typename DimExp, int Root>
+    struct dim_exp_root {
+        static_assert(DimExp::exponent % Root == 0,
+            "Roots need units whose exponents are multiples of the root.");
+        using type = unit_detail::dim_exp<typename DimExp::dimension, DimExp::exponent / Root>;
+    };
+
+    template<typename U, int Root> struct unit_root_impl;
+
+    template<typename... DimExps, int Root>
+    struct unit_root_impl<unit<DimExps...>, Root> {
+        using type = unit<typename dim_exp_root<DimExps, Root>::type...>;
+    };
+
+    template<typename R, typename U, int Root>
+    struct unit_root_impl<unit_multiple<R, U>, Root> {
+        static constexpr std::intmax_t num = exact_root<Root>(R::num);
+        static constexpr std::intmax_t den = exact_root<Root>(R::den);
+        static_assert(num > 0 and den > 0,
+            "Roots of scaled units need a scale that is an exact power; convert to the base unit first.");
+        using type = number_detail::scaled_unit<std::ratio<num, den>,
+                                                typename unit_root_impl<U, Root>::type>;
+    };
+
+    // The unit whose Root-th power is U.
+    template<typename U, int Root>
+    using unit_root = typename unit_root_impl<U, Root>::type;
+
+    template<typename R, int Power>
+    struct ratio_power_impl {
+        using type = std::ratio_multiply<R, typename ratio_power_impl<R, Power - 1>::type>;
+    };
+
+    template<typename R>
+    struct ratio_power_impl<R, 0> {
+        using type = std::ratio<1>;
+    };
+
+    template<typename R, int Power>
+    using ratio_power = meta::static_if<(Power < 0),
+        std::ratio_divide<std::ratio<1>, typename ratio_power_impl<R, (Power < 0 ? -Power : 0)>::type>,
+        typename ratio_power_impl<R, (Power < 0 ? 0 : Power)>::type>;
+
+    // U to the power Power.
+    template<typename U, int Power>
+    using unit_power = number_detail::scaled_unit<
+        ratio_power<number_detail::scale_of<U>, Power>,
+        decltype(number_detail::base_unit_of<U>{}.template exp<Power>())>;
+
+    template<typename N>
+    constexpr N abs(const N& x) noexcept {
+        if constexpr (std::is_floating_point<N>::value) {
+            // Clears the sign of -0.0 too.
+            return x < N{} or (x == N{} and std::signbit(x)) ? -x : x;
+        } else if constexpr (std::is_unsigned<N>::value) {
+            return x;
+        } else {
+            return x < N{} ? -x : x;
+        }
+    }
+
+    template<int Power, typename N>
+    constexpr N power(const N& x) noexcept {
+        if constexpr (Power < 0) {
+            static_assert(not std::is_integral<N>::value, "Negative powers need floating point numbers.");
+            return N{1} / power<-Power>(x);
+        } else {
+            N result{1};
+            for (int i = 0; i < Power; ++i) {
+                result *= x;
+            }
+            return result;
+        }
+    }
+
+    // Kernels for the elementwise functions, with SIMD paths for the vector
+    // loops of vector_detail.
+
+    struct abs_op {
+        template<typename N>
+        static constexpr N apply(const N& x) noexcept { return abs(x); }
+#if UNITS_SIMD_WIDTH == 512
+        static __m512d apply(__m512d x) noexcept { return _mm512_abs_pd(x); }
+        static __m512 apply(__m512 x) noexcept { return _mm512_abs_ps(x); }
+#elif UNITS_SIMD_WIDTH == 256
+        static __m256d apply(__m256d x) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+        static __m256 apply(__m256 x) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+#endif
+    };
+
+    struct sqrt_op {
+        template<typename N>
+        static auto apply(const N& x) noexcept { return std::sqrt(x); }
+#if UNITS_SIMD_WIDTH == 512
+        // The zero masked forms, as GCC warns about the undefined source
+        // operand of _mm512_sqrt_pd.
+        static __m512d apply(__m512d x) noexcept { return _mm512_maskz_sqrt_pd(0xff, x); }
+        static __m512 apply(__m512 x) noexcept { return _mm512_maskz_sqrt_ps(0xffff, x); }
+#elif UNITS_SIMD_WIDTH == 256
+        static __m256d apply(__m256d x) noexcept { return _mm256_sqrt_pd(x); }
+        static __m256 apply(__m256 x) noexcept { return _mm256_sqrt_ps(x); }
+#endif
+    };
+
+    // sqrt(a * a + b * b) without the scaling of std::hypot, so that lanes
+    // and the scalar tail agree. The products are not fused for the same
+    // reason.
+    // x, hidden from the optimizer by an empty asm. GCC contracts a sum of
+    // products into a fused multiply-add under its default
+    // -ffp-contract=fast, so without this some lanes of hypot would round
+    // differently from others.
+    template<typename T>
+    T rounded(T x) noexcept {
+#if UNITS_SIMD_WIDTH != 0
+        __asm__("" : "+v"(x));
+#endif
+        return x;
+    }
+
+    struct hypot_op {
+        template<typename N>
+        static auto apply(const N& a, const N& b) noexcept {
+            if constexpr (vector_detail::batch<N>::width != 0) {
+                return std::sqrt(rounded(a * a) + rounded(b * b));
+            } else {
+                return std::sqrt(a * a + b * b);
+            }
+        }
+#if UNITS_SIMD_WIDTH == 512
+        static __m512d apply(__m512d a, __m512d b) noexcept {
+            return _mm512_maskz_sqrt_pd(0xff, _mm512_add_pd(rounded(_mm512_mul_pd(a, a)),
+                                                            rounded(_mm512_mul_pd(b, b))));
+        }
+        static __m512 apply(__m512 a, __m512 b) noexcept {
+            return _mm512_maskz_sqrt_ps(0xffff, _mm512_add_ps(rounded(_mm512_mul_ps(a, a)),
+                                                              rounded(_mm512_mul_ps(b, b))));
+        }
+#elif UNITS_SIMD_WIDTH == 256
+        static __m256d apply(__m256d a, __m256d b) noexcept {
+            return _mm256_sqrt_pd(_mm256_add_pd(rounded(_mm256_mul_pd(a, a)), rounded(_mm256_mul_pd(b, b))));
+        }
+        static __m256 apply(__m256 a, __m256 b) noexcept {
+            return _mm256_sqrt_ps(_mm256_add_ps(rounded(_mm256_mul_ps(a, a)), rounded(_mm256_mul_ps(b, b))));
+        }
+#endif
+    };
+
+    // out[i] = fma(a[i], b[i], c[i]), fused in the SIMD path where the
+    // target has fused multiply-add.
+    template<typename N>
+    void fma(const N* a, const N* b, const N* c, N* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+#if UNITS_SIMD_WIDTH == 512 || (UNITS_SIMD_WIDTH == 256 && defined(__FMA__))
+        if constexpr (vector_detail::batch<N>::width != 0) {
+            using vec = vector_detail::batch<N>;
+            for (; i + vec::width <= n; i += vec::width) {
+                const auto x = vec::load(a + i);
+                const auto y = vec::load(b + i);
+                const auto z = vec::load(c + i);
+#if UNITS_SIMD_WIDTH == 512
+                if constexpr (std::is_same<N, double>::value) {
+                    vec::store(out + i, _mm512_fmadd_pd(x, y, z));
+                } else {
+                    vec::store(out + i, _mm512_fmadd_ps(x, y, z));
+                }
+#else
+                if constexpr (std::is_same<N, double>::value) {
+                    vec::store(out + i, _mm256_fmadd_pd(x, y, z));
+                } else {
+                    vec::store(out + i, _mm256_fmadd_ps(x, y, z));
+                }
+#endif
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = std::fma(a[i], b[i], c[i]);
+        }
+    }
+
+    template<typename U>
+    constexpr void check_angle() noexcept {
+        static_assert(number_detail::same_base<U, metric::angle_u>::value,
+            "Trigonometric functions take angles.");
+    }
+
+    // The number of radians in x.
+    template<typename N, typename U>
+    constexpr N radians(const unit_number<N, U>& x) noexcept {
+        check_angle<U>();
+        return number_detail::rescale<number_detail::scale_of<U>, N>(x.value());
+    }
+
+    template<typename N>
+    using angle = unit_number<N, metric::angle_u>;
+
+    template<typename N>
+    using scalar = unit_number<N, Scalar>;
+
+    template<typename A>
+    using number_of = typename decltype(vector_detail::as_span(std::declval<const A&>()))::number_type;
+
+    template<typename A>
+    using unit_of = typename decltype(vector_detail::as_span(std::declval<const A&>()))::unit_type;
+
+    template<typename A>
+    using enable_if_range = std::enable_if_t<vector_detail::is_unit_range<A>::value, int>;
+
+} /* namespace math_detail */
+
+// Math on single quantities. Units of results follow from the units of the
+// arguments, so sqrt of an area is a dist and pow<3> of a dist a volume.
+// Roots of scaled units keep an exact scale, such as sqrt of square
+// kilometers giving kilometers.
+
+template<typename N, typename U>
+constexpr unit_number<N, U> abs(const unit_number<N, U>& x) noexcept {
+    return unit_number<N, U>{math_detail::abs(x.value())};
+}
+
+template<typename N, typename U>
+constexpr const unit_number<N, U>& min(const unit_number<N, U>& a, const unit_number<N, U>& b) noexcept {
+    return b < a ? b : a;
+}
+
+template<typename N, typename U>
+constexpr const unit_number<N, U>& max(const unit_number<N, U>& a, const unit_number<N, U>& b) noexcept {
+    return a < b ? b : a;
+}
+
+template<int Power, typename N, typename U>
+constexpr auto pow(const unit_number<N, U>& x) noexcept {
+    return unit_number<N, math_detail::unit_power<U, Power>>{math_detail::power<Power>(x.value())};
+}
+
+template<typename N, typename U>
+auto sqrt(const unit_number<N, U>& x) noexcept {
+    using number_t = decltype(std::sqrt(x.value()));
+    return unit_number<number_t, math_detail::unit_root<U, 2>>{std::sqrt(x.value())};
+}
+
+template<typename N, typename U>
+auto cbrt(const unit_number<N, U>& x) noexcept {
+    using number_t = decltype(std::cbrt(x.value()));
+    return unit_number<number_t, math_detail::unit_root<U, 3>>{std::cbrt(x.value())};
+}
+
+// std::hypot, which avoids overflow and underflow of the squares.
+template<typename N, typename U>
+auto hypot(const unit_number<N, U>& a, const unit_number<N, U>& b) noexcept {
+    using number_t = decltype(std::hypot(a.value(), b.value()));
+    return unit_number<number_t, U>{std::hypot(a.value(), b.value())};
+}
+
+template<typename N, typename U>
+auto hypot(const unit_number<N, U>& a, const unit_number<N, U>& b, const unit_number<N, U>& c) noexcept {
+    using number_t = decltype(std::hypot(a.value(), b.value(), c.value()));
+    return unit_number<number_t, U>{std::hypot(a.value(), b.value(), c.value())};
+}
+
+// a * b + c with one rounding. c must have the unit of a * b.
+template<typename N, typename U, typename V, typename W>
+auto fma(const unit_number<N, U>& a, const unit_number<N, V>& b, const unit_number<N, W>& c) noexcept {
+    using product_t = decltype(a * b);
+    static_assert(std::is_same<typename product_t::unit_type, W>::value,
+        "The addend of fma needs the unit of the product.");
+    return unit_number<N, W>{std::fma(a.value(), b.value(), c.value())};
+}
+
+// Trigonometry takes angles in any scale, such as radian or degree, and
+// the inverse functions give angles in radians.
+
+template<typename N, typename U>
+auto sin(const unit_number<N, U>& x) noexcept {
+    return math_detail::scalar<N>{std::sin(math_detail::radians(x))};
+}
+
+template<typename N, typename U>
+auto cos(const unit_number<N, U>& x) noexcept {
+    return math_detail::scalar<N>{std::cos(math_detail::radians(x))};
+}
+
+template<typename N, typename U>
+auto tan(const unit_number<N, U>& x) noexcept {
+    return math_detail::scalar<N>{std::tan(math_detail::radians(x))};
+}
+
+template<typename N>
+auto asin(const unit_number<N, Scalar>& x) noexcept {
+    return math_detail::angle<N>{std::asin(x.value())};
+}
+
+template<typename N>
+auto acos(const unit_number<N, Scalar>& x) noexcept {
+    return math_detail::angle<N>{std::acos(x.value())};
+}
+
+template<typename N>
+auto atan(const unit_number<N, Scalar>& x) noexcept {
+    return math_detail::angle<N>{std::atan(x.value())};
+}
+
+template<typename N, typename U>
+auto atan2(const unit_number<N, U>& y, const unit_number<N, U>& x) noexcept {
+    return math_detail::angle<N>{std::atan2(y.value(), x.value())};
+}
+
+// Elementwise versions over unit_vector and unit_span, which run the SIMD
+// kernels of vector.h. hypot here is sqrt(a * a + b * b), as hand written
+// vector code would compute it, without the overflow guard of std::hypot.
+
+template<typename A, math_detail::enable_if_range<A> = 0>
+auto abs(const A& a) {
+    const auto x = vector_detail::as_span(a);
+    unit_vector<math_detail::number_of<A>, math_detail::unit_of<A>> result(
+        x.size(), vector_detail::uninitialized);
+    vector_detail::unary<math_detail::abs_op>(x.data(), result.data(), x.size());
+    return result;
+}
+
+template<typename A, math_detail::enable_if_range<A> = 0>
+auto sqrt(const A& a) {
+    const auto x = vector_detail::as_span(a);
+    using number_t = math_detail::number_of<A>;
+    static_assert(std::is_floating_point<number_t>::value, "Elementwise sqrt needs floating point numbers.");
+    unit_vector<number_t, math_detail::unit_root<math_detail::unit_of<A>, 2>> result(
+        x.size(), vector_detail::uninitialized);
+    vector_detail::unary<math_detail::sqrt_op>(x.data(), result.data(), x.size());
+    return result;
+}
+
+template<int Power, typename A, math_detail::enable_if_range<A> = 0>
+auto pow(const A& a) {
+    const auto x = vector_detail::as_span(a);
+    using number_t = math_detail::number_of<A>;
+    unit_vector<number_t, math_detail::unit_power<math_detail::unit_of<A>, Power>> result(
+        x.size(), vector_detail::uninitialized);
+    const number_t* in = x.data();
+    number_t* out = result.data();
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        out[i] = math_detail::power<Power>(in[i]);
+    }
+    return result;
+}
+
+template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>
+auto hypot(const A& a, const B& b) {
+    const auto x = vector_detail::as_span(a);
+    const auto y = vector_detail::as_span(b);
+    static_assert(std::is_same<math_detail::unit_of<A>, math_detail::unit_of<B>>::value and
+                  std::is_same<math_detail::number_of<A>, math_detail::number_of<B>>::value,
+        "Elementwise hypot needs operands of the same type.");
+    static_assert(std::is_floating_point<math_detail::number_of<A>>::value,
+        "Elementwise hypot needs floating point numbers.");
+    assert(x.size() == y.size());
+    unit_vector<math_detail::number_of<A>, math_detail::unit_of<A>> result(
+        x.size(), vector_detail::uninitialized);
+    vector_detail::binary<math_detail::hypot_op>(x.data(), y.data(), result.data(), x.size());
+    return result;
+}
+
+template<typename A, typename B, typename C,
+         std::enable_if_t<vector_detail::is_unit_range<A>::value and vector_detail::is_unit_range<B>::value and
+                          vector_detail::is_unit_range<C>::value, int> = 0>
+auto fma(const A& a, const B& b, const C& c) {
+    const auto x = vector_detail::as_span(a);
+    const auto y = vector_detail::as_span(b);
+    const auto z = vector_detail::as_span(c);
+    using number_t = math_detail::number_of<A>;
+    static_assert(std::is_same<number_t, math_detail::number_of<B>>::value and
+                  std::is_same<number_t, math_detail::number_of<C>>::value,
+        "Elementwise fma needs operands of the same number type.");
+    using product_t = decltype(x[0] * y[0]);
+    static_assert(std::is_same<typename product_t::unit_type, math_detail::unit_of<C>>::value,
+        "The addend of fma needs the unit of the product.");
+    assert(x.size() == y.size() and x.size() == z.size());
+    unit_vector<number_t, math_detail::unit_of<C>> result(x.size(), vector_detail::uninitialized);
+    math_detail::fma(x.data(), y.data(), z.data(), result.data(), x.size());
+    return result;
+}
+
+} /* namespace units */
+
+#endif
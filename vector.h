@@ -0,0 +1,835 @@
+#ifndef UNITS_VECTOR_H
+#define UNITS_VECTOR_H
+
+#include "number.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Elementwise kernels use AVX-512 or AVX2 when the translation unit is
+// compiled for it, and a scalar loop otherwise. Define UNITS_NO_SIMD to
+// always use the scalar loop.
+#if !defined(UNITS_NO_SIMD) && defined(__AVX512F__)
+#define UNITS_SIMD_WIDTH 512
+#elif !defined(UNITS_NO_SIMD) && defined(__AVX2__)
+#define UNITS_SIMD_WIDTH 256
+#else
+#define UNITS_SIMD_WIDTH 0
+#endif
+
+#if UNITS_SIMD_WIDTH != 0
+#include <immintrin.h>
+#endif
+
+namespace units {
+
+template<typename N, typename U> class unit_span;
+template<typename N, typename U> class unit_vector;
+template<typename E> class unit_expression;
+
+// One byte per element, 1 where the comparison holds and 0 otherwise.
+using mask_vector = std::vector<std::uint8_t>;
+
+namespace vector_detail {
+
+    // Storage of unit_vector is aligned to a cache line so that the kernels
+    // never split a vector load across two lines.
+    template<typename T, std::size_t Align = 64>
+    struct aligned_allocator {
+        using value_type = T;
+
+        template<typename V>
+        struct rebind {
+            using other = aligned_allocator<V, Align>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template<typename V>
+        aligned_allocator(const aligned_allocator<V, Align>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t{Align});
+        }
+
+        // Elements built without a value are default-initialized, which
+        // leaves trivial numbers unwritten until a kernel stores them.
+        template<typename V>
+        void construct(V* p) noexcept(std::is_nothrow_default_constructible<V>::value) {
+            ::new (static_cast<void*>(p)) V;
+        }
+
+        template<typename V, typename... Args>
+        void construct(V* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) V(std::forward<Args>(args)...);
+        }
+
+        template<typename V>
+        bool operator== (const aligned_allocator<V, Align>&) const noexcept { return true; }
+
+        template<typename V>
+        bool operator!= (const aligned_allocator<V, Align>&) const noexcept { return false; }
+    };
+
+    // Selects the unit_vector constructor that leaves its numbers
+    // uninitialized, for kernel outputs that store every element.
+    struct uninitialized_t {
+        explicit uninitialized_t() = default;
+    };
+
+    inline constexpr uninitialized_t uninitialized{};
+
+    // Loads, stores and broadcasts of the widest register holding T. width is
+    // zero for types without a SIMD path.
+    template<typename T>
+    struct batch {
+        static constexpr std::size_t width = 0;
+    };
+
+#if UNITS_SIMD_WIDTH == 512
+    template<>
+    struct batch<double> {
+        using type = __m512d;
+        static constexpr std::size_t width = 8;
+        static type load(const double* p) noexcept { return _mm512_loadu_pd(p); }
+        static void store(double* p, type x) noexcept { _mm512_storeu_pd(p, x); }
+        static type broadcast(double x) noexcept { return _mm512_set1_pd(x); }
+        template<int predicate>
+        static unsigned compare(type a, type b) noexcept {
+            return _mm512_cmp_pd_mask(a, b, predicate);
+        }
+    };
+
+    template<>
+    struct batch<float> {
+        using type = __m512;
+        static constexpr std::size_t width = 16;
+        static type load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+        static void store(float* p, type x) noexcept { _mm512_storeu_ps(p, x); }
+        static type broadcast(float x) noexcept { return _mm512_set1_ps(x); }
+        template<int predicate>
+        static unsigned compare(type a, type b) noexcept {
+            return _mm512_cmp_ps_mask(a, b, predicate);
+        }
+    };
+#elif UNITS_SIMD_WIDTH == 256
+    template<>
+    struct batch<double> {
+        using type = __m256d;
+        static constexpr std::size_t width = 4;
+        static type load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+        static void store(double* p, type x) noexcept { _mm256_storeu_pd(p, x); }
+        static type broadcast(double x) noexcept { return _mm256_set1_pd(x); }
+        template<int predicate>
+        static unsigned compare(type a, type b) noexcept {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, predicate)));
+        }
+    };
+
+    template<>
+    struct batch<float> {
+        using type = __m256;
+        static constexpr std::size_t width = 8;
+        static type load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+        static void store(float* p, type x) noexcept { _mm256_storeu_ps(p, x); }
+        static type broadcast(float x) noexcept { return _mm256_set1_ps(x); }
+        template<int predicate>
+        static unsigned compare(type a, type b) noexcept {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, predicate)));
+        }
+    };
+#endif
+
+#if UNITS_SIMD_WIDTH == 512
+#define UNITS_SIMD_OPERATION(name, intrinsic)                                  \
+    static __m512d apply(__m512d a, __m512d b) noexcept {                      \
+        return _mm512_##intrinsic##_pd(a, b);                                  \
+    }                                                                          \
+    static __m512 apply(__m512 a, __m512 b) noexcept {                         \
+        return _mm512_##intrinsic##_ps(a, b);                                  \
+    }
+#elif UNITS_SIMD_WIDTH == 256
+#define UNITS_SIMD_OPERATION(name, intrinsic)                                  \
+    static __m256d apply(__m256d a, __m256d b) noexcept {                      \
+        return _mm256_##intrinsic##_pd(a, b);                                  \
+    }                                                                          \
+    static __m256 apply(__m256 a, __m256 b) noexcept {                         \
+        return _mm256_##intrinsic##_ps(a, b);                                  \
+    }
+#else
+#define UNITS_SIMD_OPERATION(name, intrinsic)
+#endif
+
+#define UNITS_VECTOR_OPERATION(name, intrinsic, expression)                    \
+    struct name {                                                              \
+        template<typename A, typename B>                                       \
+        static constexpr auto apply(const A& a, const B& b) noexcept {         \
+            return expression;                                                 \
+        }                                                                      \
+        UNITS_SIMD_OPERATION(name, intrinsic)                                  \
+    };
+
+    UNITS_VECTOR_OPERATION(add_op, add, a + b)
+    UNITS_VECTOR_OPERATION(subtract_op, sub, a - b)
+    UNITS_VECTOR_OPERATION(multiply_op, mul, a * b)
+    UNITS_VECTOR_OPERATION(divide_op, div, a / b)
+    // Same operand order as the min/max instructions: b is returned when the
+    // comparison is false, including for NaN.
+    UNITS_VECTOR_OPERATION(min_op, min, a < b ? a : b)
+    UNITS_VECTOR_OPERATION(max_op, max, a > b ? a : b)
+
+#undef UNITS_VECTOR_OPERATION
+#undef UNITS_SIMD_OPERATION
+
+#if UNITS_SIMD_WIDTH != 0
+#define UNITS_COMPARE_PREDICATE(p) static constexpr int predicate = p;
+#else
+#define UNITS_COMPARE_PREDICATE(p)
+#endif
+
+#define UNITS_COMPARE_OPERATION(name, op, p)                                   \
+    struct name {                                                              \
+        template<typename A, typename B>                                       \
+        static constexpr bool apply(const A& a, const B& b) noexcept {         \
+            return a op b;                                                     \
+        }                                                                      \
+        UNITS_COMPARE_PREDICATE(p)                                             \
+    };
+
+    UNITS_COMPARE_OPERATION(equal_op, ==, _CMP_EQ_OQ)
+    UNITS_COMPARE_OPERATION(not_equal_op, !=, _CMP_NEQ_UQ)
+    UNITS_COMPARE_OPERATION(less_op, <, _CMP_LT_OQ)
+    UNITS_COMPARE_OPERATION(less_equal_op, <=, _CMP_LE_OQ)
+    UNITS_COMPARE_OPERATION(greater_op, >, _CMP_GT_OQ)
+    UNITS_COMPARE_OPERATION(greater_equal_op, >=, _CMP_GE_OQ)
+
+#undef UNITS_COMPARE_OPERATION
+#undef UNITS_COMPARE_PREDICATE
+
+    template<typename A, typename B, typename C>
+    struct is_batchable {
+        static constexpr bool value = std::is_same<A, C>::value and
+            std::is_same<B, C>::value and batch<C>::width != 0;
+    };
+
+    // out[i] = Op(a[i], b[i]). out may alias a or b.
+    template<typename Op, typename A, typename B, typename C>
+    void binary(const A* a, const B* b, C* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (is_batchable<A, B, C>::value) {
+            using vec = batch<C>;
+            for (; i + vec::width <= n; i += vec::width) {
+                vec::store(out + i, Op::apply(vec::load(a + i), vec::load(b + i)));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<C>(Op::apply(a[i], b[i]));
+        }
+    }
+
+    // out[i] = Op(a[i], b). out may alias a.
+    template<typename Op, typename A, typename B, typename C>
+    void binary_right(const A* a, const B& b, C* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (is_batchable<A, B, C>::value) {
+            using vec = batch<C>;
+            const auto y = vec::broadcast(b);
+            for (; i + vec::width <= n; i += vec::width) {
+                vec::store(out + i, Op::apply(vec::load(a + i), y));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<C>(Op::apply(a[i], b));
+        }
+    }
+
+    // out[i] = Op(a, b[i]). out may alias b.
+    template<typename Op, typename A, typename B, typename C>
+    void binary_left(const A& a, const B* b, C* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (is_batchable<A, B, C>::value) {
+            using vec = batch<C>;
+            const auto x = vec::broadcast(a);
+            for (; i + vec::width <= n; i += vec::width) {
+                vec::store(out + i, Op::apply(x, vec::load(b + i)));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<C>(Op::apply(a, b[i]));
+        }
+    }
+
+    // out[i] = Op(a[i]). out may alias a.
+    template<typename Op, typename A, typename C>
+    void unary(const A* a, C* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (is_batchable<A, A, C>::value) {
+            using vec = batch<C>;
+            for (; i + vec::width <= n; i += vec::width) {
+                vec::store(out + i, Op::apply(vec::load(a + i)));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<C>(Op::apply(a[i]));
+        }
+    }
+
+    template<typename T>
+    void clamp(const T* a, const T& lo, const T& hi, T* out, std::size_t n) noexcept {
+        binary_right<max_op>(a, lo, out, n);
+        binary_right<min_op>(out, hi, out, n);
+    }
+
+    // out[i] = Op(a[i], b[i]) ? 1 : 0.
+    template<typename Op, typename A, typename B>
+    void compare(const A* a, const B* b, std::uint8_t* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        if constexpr (is_batchable<A, B, A>::value) {
+            using vec = batch<A>;
+            for (; i + vec::width <= n; i += vec::width) {
+                const unsigned bits = vec::template compare<Op::predicate>(
+                    vec::load(a + i), vec::load(b + i));
+                for (std::size_t j = 0; j < vec::width; ++j) {
+                    out[i + j] = static_cast<std::uint8_t>((bits >> j) & 1u);
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = Op::apply(a[i], b[i]) ? 1 : 0;
+        }
+    }
+
+    template<typename T>
+    struct is_unit_range : public std::false_type {};
+    template<typename N, typename U>
+    struct is_unit_range<unit_span<N, U>> : public std::true_type {};
+    template<typename N, typename U>
+    struct is_unit_range<unit_vector<N, U>> : public std::true_type {};
+
+    template<typename N, typename U>
+    constexpr unit_span<const N, U> as_span(const unit_span<N, U>& x) noexcept {
+        return x;
+    }
+
+    template<typename N, typename U>
+    unit_span<const N, U> as_span(const unit_vector<N, U>& x) noexcept {
+        return x;
+    }
+
+    template<typename A, typename B>
+    using enable_if_ranges = std::enable_if_t<
+        is_unit_range<A>::value and is_unit_range<B>::value, int>;
+
+    template<typename A, typename B>
+    using enable_if_range_and_scalar = std::enable_if_t<
+        is_unit_range<A>::value and number_traits<B>::is_number, int>;
+
+    // The unit_vector holding the result of x[i] op y for quantities x and y.
+    template<typename Q>
+    using vector_of = unit_vector<typename Q::number_type, typename Q::unit_type>;
+
+    // In-place scaling keeps the number type of the range, so it must not
+    // truncate the scalar.
+    template<typename N, typename M>
+    constexpr void check_scalar() noexcept {
+        static_assert(not std::is_integral<N>::value or std::is_integral<M>::value,
+            "Scaling integral numbers in place needs an integral scalar; use * or / for a promoted result.");
+    }
+
+} /* namespace vector_detail */
+
+// Reads and writes one element of a unit_span as a unit_number.
+template<typename N, typename U>
+class unit_reference {
+public:
+    using value_type = unit_number<N, U>;
+
+    constexpr explicit unit_reference(N* p) noexcept : p_(p) {}
+
+    constexpr operator value_type() const noexcept {
+        return value_type{*p_};
+    }
+
+    constexpr const unit_reference& operator= (const value_type& x) const noexcept {
+        *p_ = x.value();
+        return *this;
+    }
+
+    constexpr const unit_reference& operator= (const unit_reference& x) const noexcept {
+        *p_ = *x.p_;
+        return *this;
+    }
+
+    template<typename M, typename V>
+    constexpr const unit_reference& operator+= (const unit_number<M, V>& x) const noexcept {
+        *p_ = (value_type{*p_} += x).value();
+        return *this;
+    }
+
+    template<typename M, typename V>
+    constexpr const unit_reference& operator-= (const unit_number<M, V>& x) const noexcept {
+        *p_ = (value_type{*p_} -= x).value();
+        return *this;
+    }
+
+    constexpr N value() const noexcept {
+        return *p_;
+    }
+
+private:
+    N* p_;
+};
+
+template<typename N, typename U>
+std::ostream& operator<< (std::ostream& os, const unit_reference<N, U>& x) {
+    return os << unit_number<N, U>{x.value()};
+}
+
+// A unit_reference takes part in expressions as the unit_number it refers to.
+// Template argument deduction does not see through its conversion operator,
+// so the operators are forwarded explicitly.
+
+#define UNITS_REFERENCE_OPERATOR(op)                                           \
+    template<typename N, typename U, typename T>                               \
+    constexpr auto operator op (const unit_reference<N, U>& a, const T& b)     \
+        noexcept -> decltype(unit_number<N, U>{a.value()} op b) {              \
+        return unit_number<N, U>{a.value()} op b;                              \
+    }                                                                          \
+    template<typename T, typename N, typename U>                               \
+    constexpr auto operator op (const T& a, const unit_reference<N, U>& b)     \
+        noexcept -> decltype(a op unit_number<N, U>{b.value()}) {              \
+        return a op unit_number<N, U>{b.value()};                              \
+    }                                                                          \
+    template<typename N, typename U, typename M, typename V>                   \
+    constexpr auto operator op (const unit_reference<N, U>& a,                 \
+                                const unit_reference<M, V>& b) noexcept        \
+        -> decltype(unit_number<N, U>{a.value()} op unit_number<M, V>{b.value()}) { \
+        return unit_number<N, U>{a.value()} op unit_number<M, V>{b.value()};   \
+    }
+
+UNITS_REFERENCE_OPERATOR(+)
+UNITS_REFERENCE_OPERATOR(-)
+UNITS_REFERENCE_OPERATOR(*)
+UNITS_REFERENCE_OPERATOR(/)
+UNITS_REFERENCE_OPERATOR(==)
+UNITS_REFERENCE_OPERATOR(!=)
+UNITS_REFERENCE_OPERATOR(<)
+UNITS_REFERENCE_OPERATOR(<=)
+UNITS_REFERENCE_OPERATOR(>)
+UNITS_REFERENCE_OPERATOR(>=)
+
+#undef UNITS_REFERENCE_OPERATOR
+
+namespace vector_detail {
+
+    // Random access iterator over a unit_span. Dereferencing gives a
+    // unit_number for constant elements and a unit_reference otherwise.
+    template<typename N, typename U>
+    class unit_iterator {
+        using number_type = std::remove_cv_t<N>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = unit_number<number_type, U>;
+        using difference_type = std::ptrdiff_t;
+        using reference = meta::static_if<std::is_const<N>::value,
+            value_type, unit_reference<number_type, U>>;
+        using pointer = void;
+
+        constexpr unit_iterator() noexcept : p_(nullptr) {}
+        constexpr explicit unit_iterator(N* p) noexcept : p_(p) {}
+
+        constexpr operator unit_iterator<const N, U>() const noexcept {
+            return unit_iterator<const N, U>{p_};
+        }
+
+        constexpr reference operator* () const noexcept { return dereference(p_); }
+        constexpr reference operator[] (difference_type i) const noexcept { return dereference(p_ + i); }
+
+        constexpr unit_iterator& operator++ () noexcept { ++p_; return *this; }
+        constexpr unit_iterator& operator-- () noexcept { --p_; return *this; }
+        constexpr unit_iterator operator++ (int) noexcept { return unit_iterator{p_++}; }
+        constexpr unit_iterator operator-- (int) noexcept { return unit_iterator{p_--}; }
+        constexpr unit_iterator& operator+= (difference_type i) noexcept { p_ += i; return *this; }
+        constexpr unit_iterator& operator-= (difference_type i) noexcept { p_ -= i; return *this; }
+
+        constexpr unit_iterator operator+ (difference_type i) const noexcept { return unit_iterator{p_ + i}; }
+        constexpr unit_iterator operator- (difference_type i) const noexcept { return unit_iterator{p_ - i}; }
+        constexpr difference_type operator- (const unit_iterator& x) const noexcept { return p_ - x.p_; }
+
+        friend constexpr unit_iterator operator+ (difference_type i, const unit_iterator& x) noexcept {
+            return x + i;
+        }
+
+        constexpr bool operator== (const unit_iterator& x) const noexcept { return p_ == x.p_; }
+        constexpr bool operator!= (const unit_iterator& x) const noexcept { return p_ != x.p_; }
+        constexpr bool operator< (const unit_iterator& x) const noexcept { return p_ < x.p_; }
+        constexpr bool operator<= (const unit_iterator& x) const noexcept { return p_ <= x.p_; }
+        constexpr bool operator> (const unit_iterator& x) const noexcept { return p_ > x.p_; }
+        constexpr bool operator>= (const unit_iterator& x) const noexcept { return p_ >= x.p_; }
+
+        // The raw number the iterator points to.
+        constexpr N* base() const noexcept { return p_; }
+
+        static constexpr reference dereference(N* p) noexcept {
+            if constexpr (std::is_const<N>::value) {
+                return value_type{*p};
+            } else {
+                return reference{p};
+            }
+        }
+
+    private:
+        N* p_;
+    };
+
+} /* namespace vector_detail */
+
+// Non-owning view of contiguous raw numbers that all carry the unit U. N may
+// be const for a read-only view.
+template<typename N, typename U>
+class unit_span {
+public:
+    using element_type = N;
+    using number_type = std::remove_cv_t<N>;
+    using unit_type = U;
+    using value_type = unit_number<number_type, U>;
+    using reference = typename vector_detail::unit_iterator<N, U>::reference;
+    using iterator = vector_detail::unit_iterator<N, U>;
+    using size_type = std::size_t;
+
+    constexpr unit_span() noexcept : data_(nullptr), size_(0) {}
+
+    constexpr unit_span(N* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    template<typename M, typename = std::enable_if_t<
+        std::is_convertible<M(*)[], N(*)[]>::value>>
+    constexpr unit_span(const unit_span<M, U>& x) noexcept : data_(x.data()), size_(x.size()) {}
+
+    constexpr N* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr reference operator[] (std::size_t i) const noexcept {
+        return iterator::dereference(data_ + i);
+    }
+
+    constexpr iterator begin() const noexcept { return iterator{data_}; }
+    constexpr iterator end() const noexcept { return iterator{data_ + size_}; }
+
+    constexpr unit_span subspan(std::size_t offset, std::size_t count) const noexcept {
+        return unit_span{data_ + offset, count};
+    }
+
+    constexpr unit_span first(std::size_t count) const noexcept {
+        return subspan(0, count);
+    }
+
+    constexpr unit_span last(std::size_t count) const noexcept {
+        return subspan(size_ - count, count);
+    }
+
+private:
+    N* data_;
+    std::size_t size_;
+};
+
+// Contiguous, cache line aligned storage of raw numbers that all carry the
+// unit U.
+template<typename N, typename U>
+class unit_vector {
+    using storage = std::vector<N, vector_detail::aligned_allocator<N>>;
+
+public:
+    using number_type = N;
+    using unit_type = U;
+    using value_type = unit_number<N, U>;
+    using reference = unit_reference<N, U>;
+    using iterator = vector_detail::unit_iterator<N, U>;
+    using const_iterator = vector_detail::unit_iterator<const N, U>;
+    using size_type = std::size_t;
+
+    unit_vector() = default;
+
+    explicit unit_vector(std::size_t size) : values_(size, N{}) {}
+
+    unit_vector(std::size_t size, const value_type& x) : values_(size, x.value()) {}
+
+    // size numbers that the caller must write before reading them.
+    unit_vector(std::size_t size, vector_detail::uninitialized_t) : values_(size) {}
+
+    unit_vector(std::initializer_list<value_type> values) {
+        values_.reserve(values.size());
+        for (const auto& x : values) {
+            values_.push_back(x.value());
+        }
+    }
+
+    template<typename M>
+    explicit unit_vector(const unit_span<M, U>& values)
+        : values_(values.data(), values.data() + values.size()) {}
+
+    // Evaluates a lazy expression of expression.h in a single pass. The
+    // storage is not zero-filled first.
+    template<typename E>
+    unit_vector(const unit_expression<E>& e) : values_(e.size()) {
+        e.template evaluate<U>(data());
+    }
+
+    template<typename E>
+    unit_vector& operator= (const unit_expression<E>& e) {
+        values_.resize(e.size());
+        e.template evaluate<U>(data());
+        return *this;
+    }
+
+    N* data() noexcept { return values_.data(); }
+    const N* data() const noexcept { return values_.data(); }
+    std::size_t size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+    std::size_t capacity() const noexcept { return values_.capacity(); }
+
+    void reserve(std::size_t size) { values_.reserve(size); }
+    void resize(std::size_t size) { values_.resize(size, N{}); }
+    void resize(std::size_t size, const value_type& x) { values_.resize(size, x.value()); }
+    void clear() noexcept { values_.clear(); }
+
+    void push_back(const value_type& x) { values_.push_back(x.value()); }
+
+    reference operator[] (std::size_t i) noexcept { return reference{data() + i}; }
+    value_type operator[] (std::size_t i) const noexcept { return value_type{values_[i]}; }
+
+    iterator begin() noexcept { return iterator{data()}; }
+    iterator end() noexcept { return iterator{data() + size()}; }
+    const_iterator begin() const noexcept { return const_iterator{data()}; }
+    const_iterator end() const noexcept { return const_iterator{data() + size()}; }
+
+    operator unit_span<N, U>() noexcept { return {data(), size()}; }
+    operator unit_span<const N, U>() const noexcept { return {data(), size()}; }
+
+    unit_span<N, U> span() noexcept { return *this; }
+    unit_span<const N, U> span() const noexcept { return *this; }
+
+private:
+    storage values_;
+};
+
+// Elementwise arithmetic. Both operands of a binary operation must have the
+// same size. The result unit is derived exactly like for single quantities.
+
+#define UNITS_VECTOR_SAME_UNIT_OPERATOR(op, kernel)                            \
+    template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>\
+    auto operator op (const A& a, const B& b) {                                \
+        const auto x = vector_detail::as_span(a);                              \
+        const auto y = vector_detail::as_span(b);                              \
+        static_assert(std::is_same<typename decltype(x)::unit_type,            \
+                                   typename decltype(y)::unit_type>::value,    \
+            "Elementwise " #op " needs operands of the same unit.");           \
+        assert(x.size() == y.size());                                          \
+        using result_t = vector_detail::vector_of<                             \
+            decltype(x[0] op y[0])>;                                           \
+        result_t result(x.size(), vector_detail::uninitialized);               \
+        vector_detail::binary<vector_detail::kernel>(                          \
+            x.data(), y.data(), result.data(), x.size());                      \
+        return result;                                                         \
+    }
+
+#define UNITS_VECTOR_PRODUCT_OPERATOR(op, kernel)                              \
+    template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>\
+    auto operator op (const A& a, const B& b) {                                \
+        const auto x = vector_detail::as_span(a);                              \
+        const auto y = vector_detail::as_span(b);                              \
+        assert(x.size() == y.size());                                          \
+        using result_t = vector_detail::vector_of<                             \
+            decltype(std::declval<typename decltype(x)::value_type>() op       \
+                     std::declval<typename decltype(y)::value_type>())>;       \
+        result_t result(x.size(), vector_detail::uninitialized);               \
+        vector_detail::binary<vector_detail::kernel>(                          \
+            x.data(), y.data(), result.data(), x.size());                      \
+        return result;                                                         \
+    }                                                                          \
+                                                                               \
+    template<typename A, typename M, typename V,                               \
+             std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>\
+    auto operator op (const A& a, const unit_number<M, V>& b) {                \
+        const auto x = vector_detail::as_span(a);                              \
+        using result_t = vector_detail::vector_of<                             \
+            decltype(std::declval<typename decltype(x)::value_type>() op b)>;  \
+        result_t result(x.size(), vector_detail::uninitialized);               \
+        vector_detail::binary_right<vector_detail::kernel>(                    \
+            x.data(), b.value(), result.data(), x.size());                     \
+        return result;                                                         \
+    }                                                                          \
+                                                                               \
+    template<typename M, typename V, typename B,                               \
+             std::enable_if_t<vector_detail::is_unit_range<B>::value, int> = 0>\
+    auto operator op (const unit_number<M, V>& a, const B& b) {                \
+        const auto y = vector_detail::as_span(b);                              \
+        using result_t = vector_detail::vector_of<                             \
+            decltype(a op std::declval<typename decltype(y)::value_type>())>;  \
+        result_t result(y.size(), vector_detail::uninitialized);               \
+        vector_detail::binary_left<vector_detail::kernel>(                     \
+            a.value(), y.data(), result.data(), y.size());                     \
+        return result;                                                         \
+    }                                                                          \
+                                                                               \
+    template<typename A, typename M,                                           \
+             vector_detail::enable_if_range_and_scalar<A, M> = 0>              \
+    auto operator op (const A& a, const M& b) {                                \
+        const auto x = vector_detail::as_span(a);                              \
+        using number_t = std::common_type_t<                                   \
+            typename decltype(x)::number_type, M>;                             \
+        using unit_t = typename decltype(x)::unit_type;                        \
+        unit_vector<number_t, unit_t> result(                                  \
+            x.size(), vector_detail::uninitialized);                           \
+        vector_detail::binary_right<vector_detail::kernel>(                    \
+            x.data(), static_cast<number_t>(b), result.data(), x.size());      \
+        return result;                                                         \
+    }
+
+UNITS_VECTOR_SAME_UNIT_OPERATOR(+, add_op)
+UNITS_VECTOR_SAME_UNIT_OPERATOR(-, subtract_op)
+UNITS_VECTOR_PRODUCT_OPERATOR(*, multiply_op)
+UNITS_VECTOR_PRODUCT_OPERATOR(/, divide_op)
+
+#undef UNITS_VECTOR_PRODUCT_OPERATOR
+#undef UNITS_VECTOR_SAME_UNIT_OPERATOR
+
+template<typename M, typename B, std::enable_if_t<
+    number_traits<M>::is_number and vector_detail::is_unit_range<B>::value, int> = 0>
+auto operator* (const M& a, const B& b) {
+    return b * a;
+}
+
+// In-place arithmetic on unit_vector and mutable unit_span.
+
+template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>
+A& operator+= (A& a, const B& b) {
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    const auto y = vector_detail::as_span(b);
+    static_assert(std::is_same<typename A::unit_type, typename decltype(y)::unit_type>::value,
+        "Elementwise += needs operands of the same unit.");
+    assert(x.size() == y.size());
+    vector_detail::binary<vector_detail::add_op>(x.data(), y.data(), x.data(), x.size());
+    return a;
+}
+
+template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>
+A& operator-= (A& a, const B& b) {
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    const auto y = vector_detail::as_span(b);
+    static_assert(std::is_same<typename A::unit_type, typename decltype(y)::unit_type>::value,
+        "Elementwise -= needs operands of the same unit.");
+    assert(x.size() == y.size());
+    vector_detail::binary<vector_detail::subtract_op>(x.data(), y.data(), x.data(), x.size());
+    return a;
+}
+
+template<typename A, typename M, vector_detail::enable_if_range_and_scalar<A, M> = 0>
+A& operator*= (A& a, const M& b) {
+    vector_detail::check_scalar<typename A::number_type, M>();
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    vector_detail::binary_right<vector_detail::multiply_op>(
+        x.data(), static_cast<typename A::number_type>(b), x.data(), x.size());
+    return a;
+}
+
+template<typename A, typename M, vector_detail::enable_if_range_and_scalar<A, M> = 0>
+A& operator/= (A& a, const M& b) {
+    vector_detail::check_scalar<typename A::number_type, M>();
+    unit_span<typename A::number_type, typename A::unit_type> x = a;
+    vector_detail::binary_right<vector_detail::divide_op>(
+        x.data(), static_cast<typename A::number_type>(b), x.data(), x.size());
+    return a;
+}
+
+// Elementwise minimum, maximum and clamping of same-unit operands. Two
+// operands of the same type get their own overload so that it is preferred
+// over std::min and std::max, which argument dependent lookup also finds.
+
+namespace vector_detail {
+
+    template<typename Op, typename A, typename B>
+    auto select(const A& a, const B& b) {
+        const auto x = as_span(a);
+        const auto y = as_span(b);
+        static_assert(std::is_same<typename decltype(x)::unit_type,
+                                   typename decltype(y)::unit_type>::value,
+            "Elementwise min and max need operands of the same unit.");
+        assert(x.size() == y.size());
+        unit_vector<typename decltype(x)::number_type, typename decltype(x)::unit_type> result(
+            x.size(), uninitialized);
+        binary<Op>(x.data(), y.data(), result.data(), x.size());
+        return result;
+    }
+
+} /* namespace vector_detail */
+
+#define UNITS_VECTOR_SELECTION(name)                                           \
+    template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>\
+    auto name(const A& a, const B& b) {                                        \
+        return vector_detail::select<vector_detail::name##_op>(a, b);          \
+    }                                                                          \
+    template<typename N, typename U>                                           \
+    auto name(const unit_vector<N, U>& a, const unit_vector<N, U>& b) {        \
+        return vector_detail::select<vector_detail::name##_op>(a, b);          \
+    }                                                                          \
+    template<typename N, typename U>                                           \
+    auto name(const unit_span<N, U>& a, const unit_span<N, U>& b) {            \
+        return vector_detail::select<vector_detail::name##_op>(a, b);          \
+    }
+
+UNITS_VECTOR_SELECTION(min)
+UNITS_VECTOR_SELECTION(max)
+
+#undef UNITS_VECTOR_SELECTION
+
+template<typename A, std::enable_if_t<vector_detail::is_unit_range<A>::value, int> = 0>
+auto clamp(const A& a, const typename A::value_type& lo, const typename A::value_type& hi) {
+    const auto x = vector_detail::as_span(a);
+    unit_vector<typename decltype(x)::number_type, typename decltype(x)::unit_type> result(
+        x.size(), vector_detail::uninitialized);
+    vector_detail::clamp(x.data(), lo.value(), hi.value(), result.data(), x.size());
+    return result;
+}
+
+// Elementwise comparisons of same-unit operands.
+
+#define UNITS_VECTOR_COMPARISON(op, kernel)                                    \
+    template<typename A, typename B, vector_detail::enable_if_ranges<A, B> = 0>\
+    mask_vector operator op (const A& a, const B& b) {                         \
+        const auto x = vector_detail::as_span(a);                              \
+        const auto y = vector_detail::as_span(b);                              \
+        static_assert(std::is_same<typename decltype(x)::unit_type,            \
+                                   typename decltype(y)::unit_type>::value,    \
+            "Elementwise " #op " needs operands of the same unit.");           \
+        assert(x.size() == y.size());                                          \
+        mask_vector result(x.size());                                          \
+        vector_detail::compare<vector_detail::kernel>(                         \
+            x.data(), y.data(), result.data(), x.size());                      \
+        return result;                                                         \
+    }
+
+UNITS_VECTOR_COMPARISON(==, equal_op)
+UNITS_VECTOR_COMPARISON(!=, not_equal_op)
+UNITS_VECTOR_COMPARISON(<, less_op)
+UNITS_VECTOR_COMPARISON(<=, less_equal_op)
+UNITS_VECTOR_COMPARISON(>, greater_op)
+UNITS_VECTOR_COMPARISON(>=, greater_equal_op)
+
+#undef UNITS_VECTOR_COMPARISON
+
+} /* namespace units */
+
+#endif